@@ -0,0 +1,74 @@
+// Display Library example for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: the e-paper panels require 3.3V supply AND data lines!
+//
+// Three panels on one SPI bus: updates one after the other, then with GxEPD2_4G_BusScheduler, and the times.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include <GxEPD2_4G_4G.h>
+#include <GxEPD2_4G_BusScheduler.h>
+
+// select the panels and adapt to your mapping; the panels share MOSI and SCK, each has its own CS, DC, RST and BUSY
+GxEPD2_426_GDEQ0426T82 panel0(/*CS=*/ 5, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4);   // GDEQ0426T82 480x800, SSD1677
+GxEPD2_426_GDEQ0426T82 panel1(/*CS=*/ 15, /*DC=*/ 27, /*RST=*/ 26, /*BUSY=*/ 25);
+GxEPD2_426_GDEQ0426T82 panel2(/*CS=*/ 13, /*DC=*/ 33, /*RST=*/ 32, /*BUSY=*/ 35);
+GxEPD2_4G_EPD* panels[] = {&panel0, &panel1, &panel2};
+const uint8_t panel_count = sizeof(panels) / sizeof(panels[0]);
+const uint8_t updates = 2; // per panel
+
+const uint8_t white = 0xFF, black = 0x00;
+uint8_t done_count[panel_count];
+
+// job write function : controller memory of one panel
+void writeScreen(GxEPD2_4G_EPD& epd2, const void* parameter)
+{
+  epd2.writeScreenBuffer(*(const uint8_t*)parameter);
+}
+
+void done(uint8_t panel, const void* parameter)
+{
+  done_count[panel]++;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println("setup");
+  for (uint8_t i = 0; i < panel_count; i++) panels[i]->init(115200);
+  // one after the other, each refresh waits for BUSY
+  uint32_t start = millis();
+  for (uint8_t u = 0; u < updates; u++)
+  {
+    for (uint8_t i = 0; i < panel_count; i++)
+    {
+      writeScreen(*panels[i], u % 2 ? &black : &white);
+      panels[i]->refresh(false);
+    }
+  }
+  uint32_t sequential = millis() - start;
+  // scheduled, writes to one panel while the others refresh
+  GxEPD2_4G_BusScheduler scheduler;
+  for (uint8_t i = 0; i < panel_count; i++) scheduler.addPanel(*panels[i], done);
+  for (uint8_t u = 0; u < updates; u++)
+  {
+    for (uint8_t i = 0; i < panel_count; i++) scheduler.queue(i, writeScreen, u % 2 ? &black : &white);
+  }
+  start = millis();
+  scheduler.run();
+  uint32_t scheduled = millis() - start;
+  bool ok = true;
+  for (uint8_t i = 0; i < panel_count; i++) ok = ok && (done_count[i] == updates);
+  Serial.print("sequential ms : "); Serial.print(sequential);
+  Serial.print(", scheduled ms : "); Serial.println(scheduled);
+  Serial.println(ok ? "all updates done" : "updates missing");
+  for (uint8_t i = 0; i < panel_count; i++) panels[i]->hibernate();
+}
+
+void loop()
+{
+}
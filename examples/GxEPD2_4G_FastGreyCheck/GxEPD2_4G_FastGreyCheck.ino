@@ -0,0 +1,170 @@
+// Display Library example for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: the e-paper panels require 3.3V supply AND data lines!
+//
+// Check of the fast grey refresh of GxEPD2_290_T94 with setFastGreyRefresh(): LUT selection, budget and refresh time.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include <GxEPD2_4G_4G.h>
+
+// select one and adapt to your mapping
+GxEPD2_4G_4G<GxEPD2_290_T94, GxEPD2_290_T94::HEIGHT / 2> display(GxEPD2_290_T94(/*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4)); // GDEM029T94 128x296, SSD1680
+
+// trace log in RAM
+class TraceBuffer : public Stream
+{
+  public:
+    TraceBuffer() : _size(0), _pos(0) {}
+    size_t write(uint8_t b)
+    {
+      if (_size >= sizeof(_data)) return 0;
+      _data[_size++] = b;
+      return 1;
+    }
+    int available()
+    {
+      return _size - _pos;
+    }
+    int read()
+    {
+      return _pos < _size ? _data[_pos++] : -1;
+    }
+    int peek()
+    {
+      return _pos < _size ? _data[_pos] : -1;
+    }
+    void clear()
+    {
+      _size = _pos = 0;
+    }
+    bool full()
+    {
+      return _size >= sizeof(_data);
+    }
+    bool sent(uint8_t command)
+    {
+      uint16_t i = 9; // header
+      while (i < _size)
+      {
+        uint8_t type = _data[i++];
+        _varint(i);
+        if (type == GxEPD2_4G_Trace::CMD)
+        {
+          if (_data[i++] == command) return true;
+        }
+        else if ((type == GxEPD2_4G_Trace::DATA) || (type == GxEPD2_4G_Trace::DATA_SCS)) i += 1 + _data[i];
+        else if (type == GxEPD2_4G_Trace::BUSY) _varint(i);
+      }
+      return false;
+    }
+  private:
+    uint32_t _varint(uint16_t& i)
+    {
+      uint32_t value = 0;
+      for (uint8_t shift = 0; (shift < 35) && (i < _size); shift += 7)
+      {
+        uint8_t b = _data[i++];
+        value |= uint32_t(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+      }
+      return value;
+    }
+    uint8_t _data[1024];
+    uint16_t _size, _pos;
+};
+
+TraceBuffer log_buffer;
+GxEPD2_4G_Trace recorder(log_buffer);
+
+const uint8_t budget = 2; // fast grey refreshes after a full grey refresh
+
+struct Step
+{
+  int16_t x, y, w, h;
+  bool fast, lut_upload; // expected
+};
+
+const Step steps[] =
+{
+  {8, 16, 64, 32, true, true},      // fast grey LUT loaded
+  {13, 100, 50, 21, true, false},   // still loaded
+  {8, 16, 64, 32, false, true},     // budget spent : full grey refresh, full grey LUT loaded again
+  {0, 0, 128, 296, false, false},   // larger than half the screen : full grey refresh
+  {-5, -7, 30, 20, true, true},     // budget restored by the full grey refresh
+};
+
+uint16_t fails = 0;
+uint32_t fast_time = 0, fast_count = 0, full_time = 0, full_count = 0;
+
+void check(bool condition, const char* what, uint8_t index)
+{
+  if (condition) return;
+  Serial.print("step "); Serial.print(index); Serial.print(" : "); Serial.println(what);
+  fails++;
+}
+
+void checkStep(uint8_t index)
+{
+  const Step& st = steps[index];
+  log_buffer.clear();
+  uint32_t busy_time = recorder.busyTime();
+  display.epd2.setTrace(&recorder);
+  display.epd2.refresh(st.x, st.y, st.w, st.h);
+  recorder.flush();
+  display.epd2.setTrace(0);
+  busy_time = recorder.busyTime() - busy_time;
+  check(!log_buffer.full(), "log full", index);
+  check(log_buffer.sent(0x20), "no refresh", index);
+  check(!log_buffer.sent(0x24) && !log_buffer.sent(0x26), "RAM written by refresh", index);
+  check(!log_buffer.sent(0x44) && !log_buffer.sent(0x45), "RAM area set, the full screen is refreshed", index);
+  check(log_buffer.sent(0x32) == st.lut_upload, st.lut_upload ? "LUT not loaded" : "LUT loaded again", index);
+  if (st.fast)
+  {
+    fast_time += busy_time;
+    fast_count++;
+  }
+  else
+  {
+    full_time += busy_time;
+    full_count++;
+  }
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println("setup");
+  display.init(115200);
+  display.epd2.setFastGreyRefresh(budget);
+  // grey content, full grey refresh
+  display.setFullWindow();
+  display.firstPage();
+  do
+  {
+    display.fillScreen(GxEPD_WHITE);
+    display.fillRect(0, 0, display.width(), display.height() / 4, GxEPD_BLACK);
+    display.fillRect(0, display.height() / 4, display.width(), display.height() / 4, GxEPD_DARKGREY);
+    display.fillRect(0, display.height() / 2, display.width(), display.height() / 4, GxEPD_LIGHTGREY);
+  }
+  while (display.nextPage());
+  for (uint8_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++)
+  {
+    checkStep(i);
+  }
+  // measured on the panel; compare with GxEPD2_290_T94::grey_fast_refresh_time, and the full grey refresh
+  Serial.print("fast grey refresh ms : "); Serial.print(fast_time / fast_count / 1000);
+  Serial.print(" (grey_fast_refresh_time "); Serial.print(GxEPD2_290_T94::grey_fast_refresh_time);
+  Serial.print("), full grey refresh ms : "); Serial.println(full_time / full_count / 1000);
+  Serial.println(fails == 0 ? "fast grey check passed" : "fast grey check FAILED");
+  display.powerOff();
+  display.hibernate();
+}
+
+void loop()
+{
+}
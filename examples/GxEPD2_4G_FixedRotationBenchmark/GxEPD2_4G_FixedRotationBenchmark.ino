@@ -0,0 +1,64 @@
+// Display Library example for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: the e-paper panels require 3.3V supply AND data lines!
+//
+// Benchmark of drawPixel() to the page buffer with compile time rotation against runtime rotation.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include <GxEPD2_4G_4G.h>
+#include <GxEPD2_4G_BW.h>
+
+// select one and adapt to your mapping; only the page buffers are used, nothing is sent to the panel
+GxEPD2_4G_4G<GxEPD2_420, GxEPD2_420::HEIGHT / 4> display(GxEPD2_420(/*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4)); // GDEW042T2 400x300, UC8176 (IL0398)
+GxEPD2_4G_4G_R<GxEPD2_420, GxEPD2_420::HEIGHT / 4, 1> display_fixed(display.epd2); // rotation 1, same panel
+GxEPD2_4G_BW_R<GxEPD2_420, GxEPD2_420::HEIGHT / 4> display_bw(display.epd2);
+GxEPD2_4G_BW_R<GxEPD2_420, GxEPD2_420::HEIGHT / 4, 1> display_bw_fixed(display.epd2);
+
+// ns per drawPixel(), all pixels of the screen, those outside of the first page are clipped
+uint32_t nsPerPixel(GxEPD2_4G_GFX_BASE_CLASS& gfx)
+{
+  uint32_t start = micros();
+  for (int16_t y = 0; y < gfx.height(); y++)
+  {
+    for (int16_t x = 0; x < gfx.width(); x++)
+    {
+      gfx.drawPixel(x, y, (x + y) & 1 ? GxEPD_BLACK : GxEPD_DARKGREY);
+    }
+#if defined(ESP8266) || defined(ESP32)
+    yield(); // avoid wdt
+#endif
+  }
+  uint32_t elapsed = micros() - start;
+  return uint32_t(uint64_t(elapsed) * 1000 / (uint32_t(gfx.width()) * gfx.height()));
+}
+
+void report(const char* name, GxEPD2_4G_GFX_BASE_CLASS& runtime, GxEPD2_4G_GFX_BASE_CLASS& fixed)
+{
+  runtime.setRotation(1);
+  uint32_t r = nsPerPixel(runtime);
+  uint32_t f = nsPerPixel(fixed);
+  Serial.print(name); Serial.print(" drawPixel ns, runtime rotation : "); Serial.print(r);
+  Serial.print(", fixed rotation : "); Serial.println(f);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println("setup");
+  display.setFullWindow();
+  display_fixed.setFullWindow();
+  display_bw.setFullWindow();
+  display_bw_fixed.setFullWindow();
+  report("GxEPD2_4G_4G", display, display_fixed);
+  report("GxEPD2_4G_BW", display_bw, display_bw_fixed);
+  Serial.println("done");
+}
+
+void loop()
+{
+}
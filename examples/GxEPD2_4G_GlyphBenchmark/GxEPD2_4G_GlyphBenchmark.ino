@@ -0,0 +1,78 @@
+// Display Library example for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: the e-paper panels require 3.3V supply AND data lines!
+//
+// Benchmark of GFXfont text to the page buffer: glyphs/s of print() against Adafruit_GFX::write() per pixel.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include <GxEPD2_4G_4G.h>
+#include <GxEPD2_4G_BW.h>
+#include <Fonts/FreeMonoBold9pt7b.h>
+
+// select one and adapt to your mapping; only the page buffer is used, nothing is sent to the panel
+GxEPD2_4G_4G<GxEPD2_420, GxEPD2_420::HEIGHT / 4> display(GxEPD2_420(/*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4)); // GDEW042T2 400x300, UC8176 (IL0398)
+GxEPD2_4G_BW_R<GxEPD2_420, GxEPD2_420::HEIGHT / 4> display_bw(display.epd2); // b/w buffer on the same panel
+
+const char text[] = "The quick brown fox jumps over the lazy dog 0123456789";
+const uint16_t repeat = 100;
+
+// glyphs/s for repeat times text, two lines within the first page
+uint32_t glyphsPerSecond(GxEPD2_4G_GFX_BASE_CLASS& gfx, bool fast)
+{
+  gfx.setFont(&FreeMonoBold9pt7b);
+  gfx.setTextColor(GxEPD_BLACK);
+  gfx.setTextSize(1);
+  gfx.setTextWrap(true);
+  uint32_t count = 0;
+  uint32_t start = micros();
+  for (uint16_t r = 0; r < repeat; r++)
+  {
+    gfx.setCursor(0, 14);
+    for (const char* p = text; *p; p++)
+    {
+      if (fast) gfx.write(*p); // print() path, GxEPD2_4G write()
+      else gfx.GxEPD2_4G_GFX_BASE_CLASS::write(*p); // drawChar() of Adafruit_GFX, pixel by pixel
+      count++;
+    }
+#if defined(ESP8266) || defined(ESP32)
+    yield(); // avoid wdt
+#endif
+  }
+  uint32_t elapsed = micros() - start;
+  return elapsed ? uint32_t(uint64_t(count) * 1000000ul / elapsed) : 0;
+}
+
+void report(const char* name, GxEPD2_4G_GFX_BASE_CLASS& gfx)
+{
+  uint32_t slow = glyphsPerSecond(gfx, false);
+  uint32_t fast = glyphsPerSecond(gfx, true);
+  Serial.print(name); Serial.print(" print() glyphs/s : "); Serial.print(fast);
+  Serial.print(", Adafruit_GFX::write() glyphs/s : "); Serial.print(slow);
+  if (slow > 0)
+  {
+    Serial.print(", x"); Serial.print(float(fast) / slow, 1);
+  }
+  Serial.println();
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println("setup");
+  display.setFullWindow();
+  display.fillScreen(GxEPD_WHITE);
+  report("GxEPD2_4G_4G", display);
+  display_bw.setFullWindow();
+  display_bw.fillScreen(GxEPD_WHITE);
+  report("GxEPD2_4G_BW", display_bw);
+  Serial.println("done");
+}
+
+void loop()
+{
+}
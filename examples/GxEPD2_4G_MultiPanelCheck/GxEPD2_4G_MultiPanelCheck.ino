@@ -0,0 +1,74 @@
+// Display Library example for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: the e-paper panels require 3.3V supply AND data lines!
+//
+// Check of GxEPD2_4G_MultiPanel on an SSD16xx panel: draws grey bands, reads them back from controller memory
+// and verifies them against the same bands written by writeImage_4G().
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include <GxEPD2_4G_4G.h>
+#include <GxEPD2_4G_MultiPanel.h>
+
+// select one of the SSD16xx panels and adapt to your mapping; more panels may be added beside it
+// readback uses the MOSI pin connected to DIN (SDA), and SCK, by bit banging; nothing else needs to be wired
+GxEPD2_426_GDEQ0426T82 panel0(/*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4); // GDEQ0426T82 480x800, SSD1677
+
+GxEPD2_4G_MultiPanel surface(GxEPD2_426_GDEQ0426T82::WIDTH, GxEPD2_426_GDEQ0426T82::HEIGHT);
+
+const int16_t x = 24, y = 100, w = 48, h = 40; // x and w multiple of 8
+uint8_t read1[w / 8 * h], read2[w / 8 * h];
+uint16_t fails = 0;
+
+void check(bool condition, const char* what)
+{
+  if (condition) return;
+  Serial.println(what);
+  fails++;
+}
+
+// grey bands of w / 4 pixels, unaligned : black, light grey, white, dark grey
+uint8_t bandLevel(int16_t i)
+{
+  const uint8_t levels[] = {0, 2, 3, 1};
+  return levels[4 * i / w];
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println("setup");
+  check(surface.hasBuffer(), "no page buffer");
+  check(surface.addPanel(panel0, 0, 0), "addPanel failed");
+  surface.init(115200);
+  surface.firstPage();
+  do
+  {
+    surface.fillScreen(GxEPD_WHITE);
+    for (int16_t i = 0; i < w; i += w / 4)
+    {
+      for (int16_t j = 0; j < h; j++)
+      {
+        for (int16_t k = i; k < i + w / 4; k++) surface.drawPixelLevel(x + k, y + j, bandLevel(k));
+      }
+    }
+  }
+  while (surface.nextPage());
+  panel0.setReadPins(MOSI, SCK);
+  check(panel0.readNativePart_4G(read1, read2, x, y, w, h), "read failed");
+  check((read1[0] == 0x00) && (read2[0] == 0x00), "black is not black");
+  uint8_t row[w / 2]; // 4bpp, nibbles 0x0 black, 0x5 dark grey, 0xA light grey, 0xF white
+  for (int16_t i = 0; i < w; i += 2) row[i / 2] = (bandLevel(i) * 0x50) | (bandLevel(i + 1) * 0x05);
+  for (int16_t i = 0; i < h; i++) panel0.writeImage_4G(row, 4, x, y + i, w, 1);
+  check(panel0.verifyNativePart_4G(read1, read2, x, y, w, h), "multi panel output differs from writeImage_4G()");
+  Serial.println(fails == 0 ? "multi panel check passed" : "multi panel check FAILED");
+  surface.hibernate();
+}
+
+void loop()
+{
+}
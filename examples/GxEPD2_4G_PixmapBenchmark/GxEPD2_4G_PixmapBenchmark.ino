@@ -0,0 +1,183 @@
+// Display Library example for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: the e-paper panels require 3.3V supply AND data lines!
+//
+// Benchmark of drawGreyPixmap() and drawInvertedBitmap() to the page buffer, against drawing pixel by pixel,
+// for all pixmap depths and rotations; the page buffers of both are compared pixel by pixel.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include <GxEPD2_4G_4G.h>
+#include "bitmaps/Bitmaps128x296.h" // 1bpp
+#include "bitmaps/WS_Bitmaps4g.h" // 2bpp
+#include "bitmaps/Bitmaps4g128x296.h" // 4bpp
+
+// select one and adapt to your mapping; only the page buffers are used, nothing is sent to the panel
+// full height buffers, for the comparison of all pixels, needs 2 * 30000 bytes of RAM, e.g. ESP32
+GxEPD2_4G_4G<GxEPD2_420, GxEPD2_420::HEIGHT> display(GxEPD2_420(/*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4)); // GDEW042T2 400x300, UC8176 (IL0398)
+GxEPD2_4G_4G_R<GxEPD2_420, GxEPD2_420::HEIGHT> reference(display.epd2); // pixel by pixel, same panel
+
+const int16_t w = 128, h = 296;
+const int16_t x = 3, y = -5; // unaligned, clipped at top
+const uint16_t repeat = 20;
+
+// 8bpp pixmap in RAM, from the 4bpp bitmap; drawGreyPixmap() reads it with pgm_read_byte(), which reads RAM on ESP8266 and ESP32
+const int16_t h8 = h / 2;
+uint8_t pixmap8[w * h8];
+
+struct Pixmap
+{
+  const char* name;
+  const uint8_t* data;
+  int16_t depth, height;
+};
+
+const Pixmap pixmaps[] =
+{
+  {"1bpp", Bitmap128x296_1, 1, h},
+  {"2bpp", WS_Bitmap4g128x296, 2, h},
+  {"4bpp", Bitmap4g128x296_1, 4, h},
+  {"8bpp", pixmap8, 8, h8},
+};
+
+uint16_t fails = 0;
+
+static uint8_t readByte(const uint8_t* p)
+{
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+  return pgm_read_byte(p);
+#else
+  return *p;
+#endif
+}
+
+// grey of pixel i, j as drawn pixel by pixel before the row blitter
+uint8_t greyOf(const Pixmap& pm, int16_t i, int16_t j)
+{
+  switch (pm.depth)
+  {
+    case 1:
+      return readByte(&pm.data[j * ((w + 7) / 8) + i / 8]) & (0x80 >> (i % 8)) ? 0xFF : 0x00;
+    case 2:
+      return (readByte(&pm.data[j * ((w + 3) / 4) + i / 4]) << (2 * (i % 4))) & 0xC0;
+    case 4:
+      {
+        uint8_t grey = (readByte(&pm.data[j * ((w + 1) / 2) + i / 2]) << (4 * (i % 2))) & 0xF0;
+        if ((grey < 0xF0) && (grey >= 0xA0)) grey = 0x80; // light grey demo limit for 4bpp
+        else if ((grey < 0xF0) && (grey > 0x00)) grey = 0x40;  // dark grey
+        return grey;
+      }
+  }
+  return readByte(&pm.data[j * w + i]);
+}
+
+void greyPixmapPerPixel(const Pixmap& pm)
+{
+  for (int16_t j = 0; j < pm.height; j++)
+  {
+    for (int16_t i = 0; i < w; i++)
+    {
+      reference.drawGreyPixel(x + i, y + j, greyOf(pm, i, j));
+    }
+  }
+}
+
+void invertedBitmapPerPixel(const uint8_t bitmap[], uint16_t color)
+{
+  for (int16_t j = 0; j < h; j++)
+  {
+    for (int16_t i = 0; i < w; i++)
+    {
+      if (!(readByte(&bitmap[j * (w / 8) + i / 8]) & (0x80 >> (i % 8)))) reference.drawPixel(x + i, y + j, color);
+    }
+  }
+}
+
+// us per draw, of the page buffer of display (blitter) or reference (per pixel)
+uint32_t measure(int8_t pixmap, bool blitter)
+{
+  uint32_t start = micros();
+  for (uint16_t r = 0; r < repeat; r++)
+  {
+    if (pixmap >= 0)
+    {
+      const Pixmap& pm = pixmaps[pixmap];
+      if (blitter) display.drawGreyPixmap(pm.data, pm.depth, x, y, w, pm.height);
+      else greyPixmapPerPixel(pm);
+    }
+    else
+    {
+      if (blitter) display.drawInvertedBitmap(x, y, Bitmap128x296_1, w, h, GxEPD_DARKGREY);
+      else invertedBitmapPerPixel(Bitmap128x296_1, GxEPD_DARKGREY);
+    }
+#if defined(ESP8266) || defined(ESP32)
+    yield(); // avoid wdt
+#endif
+  }
+  return (micros() - start) / repeat;
+}
+
+void compare(const char* name, uint8_t rotation)
+{
+  uint32_t differences = 0;
+  for (int16_t j = 0; j < display.height(); j++)
+  {
+    for (int16_t i = 0; i < display.width(); i++)
+    {
+      if (display.readPixelLevel(i, j) != reference.readPixelLevel(i, j)) differences++;
+    }
+  }
+  if (differences == 0) return;
+  Serial.print(name); Serial.print(" rotation "); Serial.print(rotation); Serial.print(" : pixels differ : "); Serial.println(differences);
+  fails++;
+}
+
+void run(const char* name, int8_t pixmap, uint8_t rotation)
+{
+  display.fillScreen(GxEPD_LIGHTGREY); // background shows pixels not drawn
+  reference.fillScreen(GxEPD_LIGHTGREY);
+  uint32_t blitter = measure(pixmap, true);
+  uint32_t per_pixel = measure(pixmap, false);
+  compare(name, rotation);
+  Serial.print(name); Serial.print(" us per draw : "); Serial.print(blitter);
+  Serial.print(", pixel by pixel : "); Serial.println(per_pixel);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println("setup");
+  for (int16_t j = 0; j < h8; j++)
+  {
+    for (int16_t i = 0; i < w; i++)
+    {
+      uint8_t nibble = (readByte(&Bitmap4g128x296_1[j * (w / 2) + i / 2]) << (4 * (i % 2))) & 0xF0;
+      pixmap8[j * w + i] = nibble | ((nibble >> 4) ^ (i & 0x0F)); // all 8 bits used
+    }
+  }
+  display.setFullWindow();
+  reference.setFullWindow();
+  for (uint8_t rotation = 0; rotation < 4; rotation++)
+  {
+    display.setRotation(rotation);
+    reference.setRotation(rotation);
+    Serial.print("rotation "); Serial.println(rotation);
+    for (uint8_t p = 0; p < sizeof(pixmaps) / sizeof(pixmaps[0]); p++)
+    {
+      char name[32];
+      snprintf(name, sizeof(name), "drawGreyPixmap %s", pixmaps[p].name);
+      run(name, p, rotation);
+    }
+    run("drawInvertedBitmap", -1, rotation);
+  }
+  Serial.println(fails == 0 ? "pixmap check passed" : "pixmap check FAILED");
+  Serial.println("done");
+}
+
+void loop()
+{
+}
@@ -0,0 +1,170 @@
+// Display Library example for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: the e-paper panels require 3.3V supply AND data lines!
+//
+// Benchmark of the planar page buffer: time to draw and write all pages, packed layout against planar layout.
+// Checks that both layouts send the same commands and data to the controller, e.g. the plane polarity of SSD16xx panels.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include <GxEPD2_4G_4G.h>
+#include <GxEPD2_4G_Trace.h>
+
+// select one and adapt to your mapping, e.g. also an SSD16xx panel
+//GxEPD2_4G_4G<GxEPD2_426_GDEQ0426T82, GxEPD2_426_GDEQ0426T82::HEIGHT / 8> display(GxEPD2_426_GDEQ0426T82(/*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4)); // GDEQ0426T82 480x800, SSD1677
+//GxEPD2_4G_4G_R<GxEPD2_426_GDEQ0426T82, GxEPD2_426_GDEQ0426T82::HEIGHT / 8, -1, false, true> display_planar(display.epd2); // planar, same panel
+GxEPD2_4G_4G<GxEPD2_420, GxEPD2_420::HEIGHT / 4> display(GxEPD2_420(/*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4)); // GDEW042T2 400x300, UC8176 (IL0398)
+GxEPD2_4G_4G_R<GxEPD2_420, GxEPD2_420::HEIGHT / 4, -1, false, true> display_planar(display.epd2); // planar, same panel
+
+// keeps power on after full refresh, so nothing is sent to the panel while it refreshes
+GxEPD2_4G_PowerPolicy power_policy(display.epd2, GxEPD2_4G_PowerPolicy::idle_timeout, 60000);
+
+// checksum of the commands and data of a trace log, time and busy records ignored
+class TraceChecksum : public Print
+{
+  public:
+    TraceChecksum() : _hash(2166136261UL), _header(9), _state(TYPE) {}
+    size_t write(uint8_t b)
+    {
+      if (_header > 0) _header--;
+      else if (_state == TYPE)
+      {
+        _type = b;
+        _state = TIME;
+      }
+      else if (_state == TIME)
+      {
+        if (!(b & 0x80)) _state = _type == GxEPD2_4G_Trace::CMD ? COMMAND : _type == GxEPD2_4G_Trace::BUSY ? BUSY_TIME : _type == GxEPD2_4G_Trace::RESET ? TYPE : COUNT;
+        if (_type == GxEPD2_4G_Trace::RESET) _add(0xFF);
+      }
+      else if (_state == COMMAND)
+      {
+        _add(GxEPD2_4G_Trace::CMD);
+        _add(b);
+        _state = TYPE;
+      }
+      else if (_state == COUNT)
+      {
+        _count = b;
+        _state = DATA;
+      }
+      else if (_state == DATA)
+      {
+        _add(b); // independent of the split of the data in records
+        if (--_count == 0) _state = TYPE;
+      }
+      else if (!(b & 0x80)) _state = TYPE; // BUSY_TIME
+      return 1;
+    }
+    uint32_t checksum()
+    {
+      return _hash;
+    }
+  private:
+    void _add(uint8_t b)
+    {
+      _hash = (_hash ^ b) * 16777619UL; // FNV-1a
+    }
+    enum State {TYPE, TIME, COMMAND, COUNT, DATA, BUSY_TIME};
+    uint32_t _hash;
+    uint8_t _header, _type, _count;
+    State _state;
+};
+
+void draw(GxEPD2_4G_GFX_BASE_CLASS& gfx)
+{
+  gfx.fillScreen(GxEPD_WHITE);
+  gfx.fillRect(0, 0, gfx.width() / 4, gfx.height(), GxEPD_BLACK);
+  gfx.fillRect(gfx.width() / 4, 0, gfx.width() / 4, gfx.height(), GxEPD_DARKGREY);
+  gfx.fillRect(gfx.width() / 2, 0, gfx.width() / 4, gfx.height(), GxEPD_LIGHTGREY);
+}
+
+void drawCallback(const void* parameter)
+{
+  draw(*(GxEPD2_4G_GFX_BASE_CLASS*)parameter);
+}
+
+void packedPages()
+{
+  display.firstPage();
+  do draw(display);
+  while (display.nextPage());
+}
+
+void planarPages()
+{
+  display_planar.firstPage();
+  do draw(display_planar);
+  while (display_planar.nextPage());
+}
+
+void packedPaged()
+{
+  display.drawPaged(drawCallback, &display);
+}
+
+void planarPaged()
+{
+  display_planar.drawPaged(drawCallback, &display_planar);
+}
+
+// us from first page to the start of the refresh; the refresh is not waited for, by deferred busy wait
+uint32_t timed(void (*update)())
+{
+  display.epd2.setDeferredBusyWait(true);
+  uint32_t start = micros();
+  update();
+  uint32_t elapsed = micros() - start;
+  display.epd2.setDeferredBusyWait(false); // waits for the end of the refresh
+  return elapsed;
+}
+
+// checksum of what the update sends to the controller
+uint32_t traced(void (*update)())
+{
+  TraceChecksum checksum;
+  GxEPD2_4G_Trace trace(checksum);
+  display.epd2.setTrace(&trace);
+  update();
+  display.epd2.setTrace(0);
+  return checksum.checksum();
+}
+
+void check(const char* name, void (*packed)(), void (*planar)())
+{
+  bool same = traced(packed) == traced(planar);
+  Serial.print(name); Serial.println(same ? " planar output same as packed output" : " planar output differs from packed output, FAILED");
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println("setup");
+  display.init(115200);
+  display.setPowerPolicy(&power_policy);
+  display_planar.setPowerPolicy(&power_policy);
+  display.setFullWindow();
+  display_planar.setFullWindow();
+  timed(packedPages); // initial update, clears controller memory
+  uint32_t packed_pages = timed(packedPages);
+  uint32_t planar_pages = timed(planarPages);
+  uint32_t packed_paged = timed(packedPaged);
+  uint32_t planar_paged = timed(planarPaged);
+  Serial.print("nextPage() packed us : "); Serial.print(packed_pages); Serial.print(", planar us : "); Serial.println(planar_pages);
+  Serial.print("drawPaged() packed us : "); Serial.print(packed_paged); Serial.print(", planar us : "); Serial.println(planar_paged);
+  check("nextPage()", packedPages, planarPages);
+  check("drawPaged()", packedPaged, planarPaged);
+  display.setPowerPolicy(0);
+  display_planar.setPowerPolicy(0);
+  display.powerOff();
+  display.hibernate();
+  Serial.println("done");
+}
+
+void loop()
+{
+}
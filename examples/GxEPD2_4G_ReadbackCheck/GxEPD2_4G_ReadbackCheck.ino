@@ -0,0 +1,84 @@
+// Display Library example for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: the e-paper panels require 3.3V supply AND data lines!
+//
+// Check of controller RAM readback of SSD16xx panels: writes a native window, reads it back and compares.
+// Checks that GxEPD2_4G_Direct, with merge, writes the same grey levels as writeImage_4G().
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include <GxEPD2_4G_4G.h>
+#include <GxEPD2_4G_Direct.h>
+
+// select one of the SSD16xx panels and adapt to your mapping
+// readback uses the MOSI pin connected to DIN (SDA), and SCK, by bit banging; nothing else needs to be wired
+GxEPD2_4G_4G<GxEPD2_290_T94, GxEPD2_290_T94::HEIGHT / 4> display(GxEPD2_290_T94(/*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4)); // GDEM029T94 128x296, SSD1680
+
+const int16_t x = 24, y = 100, w = 48, h = 40; // x and w multiple of 8
+uint8_t plane1[w / 8 * h], plane2[w / 8 * h], read1[w / 8 * h], read2[w / 8 * h];
+uint16_t fails = 0;
+
+void check(bool condition, const char* what)
+{
+  if (condition) return;
+  Serial.println(what);
+  fails++;
+}
+
+// grey bands of w / 4 pixels, unaligned : black, light grey, white, dark grey
+uint8_t bandLevel(int16_t i)
+{
+  const uint8_t levels[] = {0, 2, 3, 1};
+  return levels[4 * i / w];
+}
+
+void checkDirect()
+{
+  GxEPD2_4G_Direct direct(display.epd2);
+  direct.fillRect(x, y, w, h, 1); // aligned, dark grey background of the last band
+  direct.setMerge(true); // the edges of the unaligned bands are read back
+  for (int16_t i = 0; i < 3 * w / 4; i += w / 4) direct.fillRect(x + i, y, w / 4, h, bandLevel(i));
+  check(display.epd2.readNativePart_4G(read1, read2, x, y, w, h), "read failed");
+  check((read1[0] == 0x00) && (read2[0] == 0x00), "direct black is not black");
+  uint8_t row[w / 2]; // 4bpp, nibbles 0x0 black, 0x5 dark grey, 0xA light grey, 0xF white
+  for (int16_t i = 0; i < w; i += 2) row[i / 2] = (bandLevel(i) * 0x50) | (bandLevel(i + 1) * 0x05);
+  for (int16_t i = 0; i < h; i++) display.epd2.writeImage_4G(row, 4, x, y + i, w, 1);
+  check(display.epd2.verifyNativePart_4G(read1, read2, x, y, w, h), "direct differs from writeImage_4G()");
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println("setup");
+  display.init(115200);
+  uint32_t seed = 7;
+  for (uint16_t i = 0; i < sizeof(plane1); i++)
+  {
+    seed = seed * 1103515245ul + 12345;
+    plane1[i] = seed >> 16;
+    plane2[i] = seed >> 24;
+  }
+  check(!display.epd2.readNativePart_4G(read1, read2, x, y, w, h), "read without read pins");
+  display.epd2.setReadPins(MOSI, SCK);
+  display.epd2.writeNativePart_4G(plane1, plane2, 0, 0, w, h, x, y, w, h);
+  uint32_t start = micros();
+  check(display.epd2.readNativePart_4G(read1, read2, x, y, w, h), "read failed");
+  uint32_t elapsed = micros() - start;
+  check(!memcmp(plane1, read1, sizeof(plane1)) && !memcmp(plane2, read2, sizeof(plane2)), "read data differs");
+  check(display.epd2.verifyNativePart_4G(plane1, plane2, x, y, w, h), "verify failed");
+  plane2[sizeof(plane2) / 2] ^= 0x10; // one pixel differs
+  check(!display.epd2.verifyNativePart_4G(plane1, plane2, x, y, w, h), "verify missed a difference");
+  check(!display.epd2.readNativePart_4G(read1, read2, x + 4, y, w, h), "read of unaligned x");
+  checkDirect();
+  Serial.print("read of "); Serial.print(2 * sizeof(read1)); Serial.print(" bytes us : "); Serial.println(elapsed);
+  Serial.println(fails == 0 ? "readback check passed" : "readback check FAILED");
+  display.hibernate();
+}
+
+void loop()
+{
+}
@@ -0,0 +1,75 @@
+// Display Library example for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: the e-paper panels require 3.3V supply AND data lines!
+//
+// Benchmark of anti-aliased text to the page buffer: glyphs/s and GxEPD2_4G_GlyphCache hits and misses.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include <GxEPD2_4G_4G.h>
+#include <Fonts/FreeSans9pt7b.h>
+#include <Fonts/FreeSans18pt7b.h>
+
+// select one and adapt to your mapping; only the page buffer is used, nothing is sent to the panel
+GxEPD2_4G_4G<GxEPD2_420, GxEPD2_420::HEIGHT / 4> display(GxEPD2_420(/*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4)); // GDEW042T2 400x300, UC8176 (IL0398)
+
+GxEPD2_4G_GlyphCache glyph_cache;
+
+const uint16_t repeat = 100;
+
+// glyphs/s for repeat times text at the start of the first page
+uint32_t glyphsPerSecond(const char* text)
+{
+  uint32_t count = 0;
+  uint32_t start = micros();
+  for (uint16_t r = 0; r < repeat; r++)
+  {
+    display.setCursor(0, 20);
+    count += display.print(text);
+#if defined(ESP8266) || defined(ESP32)
+    yield(); // avoid wdt
+#endif
+  }
+  uint32_t elapsed = micros() - start;
+  return elapsed ? uint32_t(uint64_t(count) * 1000000ul / elapsed) : 0;
+}
+
+void report(const char* name, const char* text, bool antialiased)
+{
+  display.fillScreen(GxEPD_WHITE);
+  display.setTextAntialiasing(antialiased ? &glyph_cache : 0);
+  display.setFont(antialiased ? &FreeSans18pt7b : &FreeSans9pt7b);
+  glyph_cache.clear(); // also clears hits and misses
+  uint32_t rate = glyphsPerSecond(text);
+  Serial.print(name); Serial.print(" glyphs/s : "); Serial.print(rate);
+  if (antialiased)
+  {
+    Serial.print(", cache hits : "); Serial.print(glyph_cache.hits());
+    Serial.print(", misses : "); Serial.print(glyph_cache.misses());
+  }
+  Serial.println();
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println("setup");
+  display.setFullWindow();
+  display.setTextColor(GxEPD_BLACK);
+  // few distinct glyphs, e.g. a clock, fit the cache
+  report("clock 9pt", "12:34", false);
+  report("clock anti-aliased", "12:34", true);
+  // more distinct glyphs than cache entries, rasterized on most uses
+  report("text 9pt", "Quick brown fox", false);
+  report("text anti-aliased", "Quick brown fox", true);
+  display.setTextAntialiasing(0);
+  Serial.println("done");
+}
+
+void loop()
+{
+}
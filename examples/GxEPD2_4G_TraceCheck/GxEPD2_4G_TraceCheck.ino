@@ -0,0 +1,150 @@
+// Display Library example for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: the e-paper panels require 3.3V supply AND data lines!
+//
+// Check of the command trace: records an update, replays it timed, and compares the timing.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include <GxEPD2_4G_BW.h>
+
+// select one and adapt to your mapping
+GxEPD2_4G_BW<GxEPD2_420, GxEPD2_420::HEIGHT / 4> display(GxEPD2_420(/*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4)); // GDEW042T2 400x300, UC8176 (IL0398)
+
+// trace log in RAM
+class TraceBuffer : public Stream
+{
+  public:
+    TraceBuffer() : _size(0), _pos(0) {}
+    size_t write(uint8_t b)
+    {
+      if (_size >= sizeof(_data)) return 0;
+      _data[_size++] = b;
+      return 1;
+    }
+    int available()
+    {
+      return _size - _pos;
+    }
+    int read()
+    {
+      return _pos < _size ? _data[_pos++] : -1;
+    }
+    int peek()
+    {
+      return _pos < _size ? _data[_pos] : -1;
+    }
+    void rewind()
+    {
+      _pos = 0;
+    }
+    bool full()
+    {
+      return _size >= sizeof(_data);
+    }
+    // sum of the record deltas in us, i.e. time from begin() to the last record; records and per byte CS data counted
+    uint32_t duration(uint32_t& records, uint32_t& scs_bytes)
+    {
+      uint32_t sum = 0;
+      records = 0;
+      scs_bytes = 0;
+      uint16_t i = 9; // header
+      while (i < _size)
+      {
+        uint8_t type = _data[i++];
+        sum += _varint(i);
+        if (type == GxEPD2_4G_Trace::CMD) i++;
+        else if (type == GxEPD2_4G_Trace::DATA) i += 1 + _data[i];
+        else if (type == GxEPD2_4G_Trace::DATA_SCS)
+        {
+          scs_bytes += _data[i];
+          i += 1 + _data[i];
+        }
+        else if (type == GxEPD2_4G_Trace::BUSY) _varint(i);
+        records++;
+      }
+      return sum;
+    }
+  private:
+    uint32_t _varint(uint16_t& i)
+    {
+      uint32_t value = 0;
+      for (uint8_t shift = 0; (shift < 35) && (i < _size); shift += 7)
+      {
+        uint8_t b = _data[i++];
+        value |= uint32_t(b & 0x7F) << shift;
+        if (!(b & 0x80)) break;
+      }
+      return value;
+    }
+    uint8_t _data[4096];
+    uint16_t _size, _pos;
+};
+
+TraceBuffer recorded, replayed;
+GxEPD2_4G_Trace recorder(recorded), replay_recorder(replayed);
+
+void update()
+{
+  display.setPartialWindow(0, 0, 64, 64);
+  display.firstPage();
+  do
+  {
+    display.fillScreen(GxEPD_WHITE);
+    display.fillRect(8, 8, 48, 48, GxEPD_BLACK);
+  }
+  while (display.nextPage());
+  display.powerOff();
+}
+
+// within 10% or 20ms
+bool near(uint32_t a, uint32_t b)
+{
+  uint32_t d = a > b ? a - b : b - a;
+  uint32_t m = a > b ? a : b;
+  return (d <= m / 10) || (d <= 20000);
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println("setup");
+  display.init(115200);
+  update(); // initial full refresh
+  uint32_t start = micros();
+  display.epd2.setTrace(&recorder);
+  update();
+  recorder.flush();
+  display.epd2.setTrace(0);
+  uint32_t recording_time = micros() - start;
+  uint32_t records, replayed_records, scs_bytes, replayed_scs_bytes;
+  uint32_t recorded_duration = recorded.duration(records, scs_bytes);
+  GxEPD2_4G_TracePlayer player(display.epd2);
+  start = micros();
+  display.epd2.setTrace(&replay_recorder);
+  bool played = player.play(recorded, true);
+  replay_recorder.flush();
+  display.epd2.setTrace(0);
+  uint32_t replay_time = micros() - start;
+  uint32_t replayed_duration = replayed.duration(replayed_records, replayed_scs_bytes);
+  bool ok = played && !recorded.full() && (player.records() == records) && (replayed_records == records);
+  ok = ok && (replayed_scs_bytes == scs_bytes); // per byte chip select kept, e.g. LUT uploads of GxEPD2_270
+  ok = ok && (recorded_duration <= recording_time) && near(recorded_duration, recording_time); // no wrapped deltas
+  ok = ok && near(replay_time, recording_time) && near(replayed_duration, recorded_duration);
+  ok = ok && near(replay_recorder.busyTime(), recorder.busyTime());
+  Serial.print("records : "); Serial.print(records); Serial.print(" replayed : "); Serial.println(player.records());
+  Serial.print("recording us : "); Serial.print(recording_time); Serial.print(" log : "); Serial.println(recorded_duration);
+  Serial.print("replay us : "); Serial.print(replay_time); Serial.print(" log : "); Serial.println(replayed_duration);
+  Serial.print("per byte CS data : "); Serial.print(scs_bytes); Serial.print(" replayed : "); Serial.println(replayed_scs_bytes);
+  Serial.print("busy us : "); Serial.print(recorder.busyTime()); Serial.print(" replayed : "); Serial.println(replay_recorder.busyTime());
+  Serial.println(ok ? "trace check passed" : "trace check FAILED");
+  display.hibernate();
+}
+
+void loop()
+{
+}
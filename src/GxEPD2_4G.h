@@ -109,6 +109,19 @@ class GxEPD2_4G
       GDEY073D46,
       ACeP730,     Waveshare_7_30_7c = ACeP730
     };
+    // grey level of a color, 0 : black, 1 : dark grey, 2 : light grey, 3 : white; other colors by brightness
+    static inline uint8_t colorLevel(uint16_t color)
+    {
+      switch (color)
+      {
+        case GxEPD_BLACK: return 0x00;
+        case GxEPD_DARKGREY: return 0x01;
+        case GxEPD_LIGHTGREY: return 0x02;
+        case GxEPD_WHITE: return 0x03;
+      }
+      uint32_t brightness = (uint32_t(color & 0xF800) + uint32_t((color & 0x07E0) << 5) + uint32_t((color & 0x001F) << 11));
+      return uint8_t((brightness - 1) / 0xC000ul); // GxEPD_LIGHTGREY is one too high
+    }
 };
 
 #endif
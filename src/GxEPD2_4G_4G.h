@@ -31,6 +31,9 @@
 #endif
 
 #include "GxEPD2_4G_EPD.h"
+#include "GxEPD2_4G_PowerPolicy.h"
+#include "GxEPD2_4G_GlyphCache.h"
+#include "GxEPD2_4G_Canvas.h"
 
 #if defined __has_include
 #  if __has_include("GxEPD2_4G_EPD.h")
@@ -71,7 +74,10 @@
 #endif
 #include "epd/GxEPD2_750_T7.h"
 
-template<typename GxEPD2_Type, const uint16_t page_height>
+// fixed_rotation 0..3 : rotation and mirror are compile time constants, for faster pixel transforms
+// setRotation() and mirror() have no effect then; -1 (default) : rotation and mirror can be changed at runtime
+// planar true : the page buffer holds the two 1bpp controller planes, written without conversion by writeNativePart_4G()
+template<typename GxEPD2_Type, const uint16_t page_height, const int8_t fixed_rotation = -1, const bool fixed_mirror = false, const bool planar = false>
 class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
 {
   public:
@@ -84,10 +90,14 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
     {
       _page_height = page_height;
       _pages = (HEIGHT / _page_height) + ((HEIGHT % _page_height) > 0);
-      _reverse = (epd2_instance.panel == GxEPD2_4G::GDE0213B1);
-      _mirror = false;
+      _mirror = fixed_mirror;
+      if (fixed_rotation >= 0) GxEPD2_4G_GFX_BASE_CLASS::setRotation(fixed_rotation);
       _using_partial_mode = false;
       _current_page = 0;
+      _power_policy = 0;
+      _glyph_cache = 0;
+      _aa_cursor_x = 0;
+      _aa_phase = 0;
       setFullWindow();
     }
 
@@ -103,16 +113,38 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
 
     bool mirror(bool m)
     {
+      if (fixed_rotation >= 0) return fixed_mirror;
       _swap_ (_mirror, m);
       return m;
     }
 
+    void setRotation(uint8_t r)
+    {
+      GxEPD2_4G_GFX_BASE_CLASS::setRotation(fixed_rotation >= 0 ? fixed_rotation : r);
+    }
+
     void drawPixel(int16_t x, int16_t y, uint16_t color)
+    {
+      drawPixelLevel(x, y, colorLevel(color));
+    }
+
+    void drawGreyPixel(int16_t x, int16_t y, uint8_t grey)
+    {
+      drawPixelLevel(x, y, grey >> 6);
+    }
+
+    // grey level API, level 0 : black, 1 : dark grey, 2 : light grey, 3 : white
+    static inline uint8_t colorLevel(uint16_t color)
+    {
+      return GxEPD2_4G::colorLevel(color);
+    }
+
+    void drawPixelLevel(int16_t x, int16_t y, uint8_t level)
     {
       if ((x < 0) || (x >= width()) || (y < 0) || (y >= height())) return;
-      if (_mirror) x = width() - x - 1;
+      if (_mirrored()) x = width() - x - 1;
       // check rotation, move pixel around if necessary
-      switch (getRotation())
+      switch (_rotation())
       {
         case 1:
           _swap_(x, y);
@@ -137,53 +169,219 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
       y -= _current_page * _page_height;
       // check if in current page
       if ((y < 0) || (y >= int16_t(_page_height))) return;
-      uint16_t i = x / 4 + y * (_pw_w / 4);
-      _buffer[i] = (_buffer[i] & (0xFF ^ (3 << 2 * (3 - x % 4))));
-      if (color > 0)
+      _writeLevel(x, y, level & 0x03);
+    }
+
+    // grey level of pixel x, y in the page buffer, -1 if outside of the (partial) window or of the current page
+    int8_t readPixelLevel(int16_t x, int16_t y)
+    {
+      if ((x < 0) || (x >= width()) || (y < 0) || (y >= height())) return -1;
+      _toPage(x, y);
+      if ((x < 0) || (x >= int16_t(_pw_w)) || (y < 0) || (y >= int16_t(_page_height))) return -1;
+      if (y + _current_page * _page_height >= _pw_h) return -1;
+      return _readLevel(x, y);
+    }
+
+    void drawFastHLineLevel(int16_t x, int16_t y, int16_t w, uint8_t level)
+    {
+      fillRectLevel(x, y, w, 1, level);
+    }
+
+    void drawFastVLineLevel(int16_t x, int16_t y, int16_t h, uint8_t level)
+    {
+      fillRectLevel(x, y, 1, h, level);
+    }
+
+    void fillRectLevel(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t level)
+    {
+      if ((w <= 0) || (h <= 0)) return;
+      // corners in page buffer coordinates, the rectangle stays a rectangle
+      int16_t x0 = x, y0 = y, x1 = x + w - 1, y1 = y + h - 1;
+      _toPage(x0, y0);
+      _toPage(x1, y1);
+      if (x0 > x1) _swap_(x0, x1);
+      if (y0 > y1) _swap_(y0, y1);
+      int16_t page_h = int16_t(_pw_h) - int16_t(_current_page * _page_height); // rows of window on this page
+      if (page_h > int16_t(_page_height)) page_h = _page_height;
+      if (x0 < 0) x0 = 0;
+      if (y0 < 0) y0 = 0;
+      if (x1 >= int16_t(_pw_w)) x1 = _pw_w - 1;
+      if (y1 >= page_h) y1 = page_h - 1;
+      if ((x0 > x1) || (y0 > y1)) return;
+      level &= 0x03;
+      if (planar)
       {
-        uint8_t brb = 0x03;
-        if (color != GxEPD_WHITE)
+        // bit masks of first and last byte of each plane row
+        uint8_t m0 = 0xFF >> (x0 % 8), m1 = 0xFF << (7 - x1 % 8);
+        if (x0 / 8 == x1 / 8) m0 = m1 = m0 & m1;
+        uint8_t* planes[2] = {_buffer, _buffer + _plane_size};
+        for (uint8_t k = 0; k < 2; k++)
+        {
+          uint8_t ink = (level & (2 >> k)) ? 0xFF : 0x00;
+          for (int16_t py = y0; py <= y1; py++)
+          {
+            uint8_t* row = planes[k] + py * (_pw_w / 8);
+            row[x0 / 8] = (row[x0 / 8] & ~m0) | (ink & m0);
+            for (int16_t b = x0 / 8 + 1; b < x1 / 8; b++) row[b] = ink;
+            row[x1 / 8] = (row[x1 / 8] & ~m1) | (ink & m1);
+          }
+        }
+        return;
+      }
+      uint8_t pattern = level * 0b01010101;
+      for (int16_t py = y0; py <= y1; py++)
+      {
+        uint8_t* row = _buffer + py * (_pw_w / 4);
+        int16_t px = x0;
+        for (; (px <= x1) && (px % 4); px++) // leading pixels
+        {
+          uint8_t shift = 2 * (3 - px % 4);
+          row[px / 4] = (row[px / 4] & (0xFF ^ (3 << shift))) | (level << shift);
+        }
+        for (; px + 3 <= x1; px += 4) row[px / 4] = pattern; // whole bytes
+        for (; px <= x1; px++) // trailing pixels
         {
-          uint32_t brightness = (uint32_t(color & 0xF800) + uint32_t((color & 0x07E0) << 5) + uint32_t((color & 0x001F) << 11));
-          brb = uint8_t((brightness - 1) / 0xC000ul); // GxEPD_LIGHTGREY is one too high
+          uint8_t shift = 2 * (3 - px % 4);
+          row[px / 4] = (row[px / 4] & (0xFF ^ (3 << shift))) | (level << shift);
         }
-        _buffer[i] = (_buffer[i] | (brb << 2 * (3 - x % 4)));
       }
     }
 
-    void drawGreyPixel(int16_t x, int16_t y, uint8_t grey)
+    void fillScreenLevel(uint8_t level)
     {
-      if ((x < 0) || (x >= width()) || (y < 0) || (y >= height())) return;
-      if (_mirror) x = width() - x - 1;
-      // check rotation, move pixel around if necessary
-      switch (getRotation())
+      uint8_t data = (level & 0x03) * 0b01010101;
+      if (planar)
       {
-        case 1:
-          _swap_(x, y);
-          x = WIDTH - x - 1;
-          break;
-        case 2:
-          x = WIDTH - x - 1;
-          y = HEIGHT - y - 1;
-          break;
-        case 3:
-          _swap_(x, y);
-          y = HEIGHT - y - 1;
-          break;
+        for (uint16_t x = 0; x < _plane_size; x++)
+        {
+          _buffer[x] = (level & 0x02) ? 0xFF : 0x00;
+          _buffer[x + _plane_size] = (level & 0x01) ? 0xFF : 0x00;
+        }
+        return;
+      }
+      for (uint16_t x = 0; x < sizeof(_buffer); x++)
+      {
+        _buffer[x] = data;
       }
-      // transpose partial window to 0,0
-      x -= _pw_x;
-      if (!_reverse) y -= _pw_y;
-      else y = HEIGHT - _pw_y - y - 1;
-      // clip to (partial) window
-      if ((x < 0) || (x >= _pw_w) || (y < 0) || (y >= _pw_h)) return;
-      // adjust for current page
-      y -= _current_page * _page_height;
-      // check if in current page
-      if ((y < 0) || (y >= _page_height)) return;
-      uint16_t i = x / 4 + y * (_pw_w / 4);
-      _buffer[i] = (_buffer[i] & (0xFF ^ (3 << 2 * (3 - x % 4))));
-      _buffer[i] = (_buffer[i] | ((grey >> 6) << 2 * (3 - x % 4)));
+    }
+
+    // Adafruit_GFX fills and lines use the grey level spans
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+    {
+      if (w > 0) fillRectLevel(x, y, w, 1, colorLevel(color));
+      else GxEPD2_4G_GFX_BASE_CLASS::drawFastHLine(x, y, w, color);
+    }
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+    {
+      if (h > 0) fillRectLevel(x, y, 1, h, colorLevel(color));
+      else GxEPD2_4G_GFX_BASE_CLASS::drawFastVLine(x, y, h, color);
+    }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+    {
+      if ((w > 0) && (h > 0)) fillRectLevel(x, y, w, h, colorLevel(color));
+      else GxEPD2_4G_GFX_BASE_CLASS::fillRect(x, y, w, h, color);
+    }
+
+    // fast path for GFXfont text of size 1: glyph bits are written directly to the page buffer
+    // glyphs completely outside of the (partial) window or the current page are skipped
+    using GxEPD2_4G_GFX_BASE_CLASS::drawChar;
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y)
+    {
+      if (!gfxFont || (size_x != 1) || (size_y != 1)) return GxEPD2_4G_GFX_BASE_CLASS::drawChar(x, y, c, color, bg, size_x, size_y);
+      uint8_t first = pgm_read_byte(&gfxFont->first);
+      if ((c < first) || (c > (uint8_t)pgm_read_word(&gfxFont->last))) return;
+      const GFXglyph* glyph = ((const GFXglyph*)_pgm_read_pointer(&gfxFont->glyph)) + (c - first);
+      const uint8_t* bitmap = (const uint8_t*)_pgm_read_pointer(&gfxFont->bitmap);
+      uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
+      int16_t w = pgm_read_byte(&glyph->width);
+      int16_t h = pgm_read_byte(&glyph->height);
+      int16_t xo = int8_t(pgm_read_byte(&glyph->xOffset));
+      int16_t yo = int8_t(pgm_read_byte(&glyph->yOffset));
+      if ((w == 0) || (h == 0)) return;
+      // glyph origin and steps for next column (ax, ay) and next row (cx, cy) in page buffer coordinates
+      int16_t x0 = x + xo, y0 = y + yo;
+      int16_t ax = x0 + 1, ay = y0, cx = x0, cy = y0 + 1;
+      _toPage(x0, y0);
+      _toPage(ax, ay);
+      _toPage(cx, cy);
+      ax -= x0;
+      ay -= y0;
+      cx -= x0;
+      cy -= y0;
+      // glyph box in page buffer coordinates, clip once per glyph
+      int16_t x1 = x0 + (w - 1) * ax + (h - 1) * cx;
+      int16_t y1 = y0 + (w - 1) * ay + (h - 1) * cy;
+      int16_t page_h = int16_t(_pw_h) - int16_t(_current_page * _page_height); // rows of window on this page
+      if (page_h > int16_t(_page_height)) page_h = _page_height;
+      int16_t xmin = x0 < x1 ? x0 : x1, xmax = x0 < x1 ? x1 : x0;
+      int16_t ymin = y0 < y1 ? y0 : y1, ymax = y0 < y1 ? y1 : y0;
+      if ((xmax < 0) || (xmin >= int16_t(_pw_w)) || (ymax < 0) || (ymin >= page_h)) return;
+      bool clip = (xmin < 0) || (xmax >= int16_t(_pw_w)) || (ymin < 0) || (ymax >= page_h);
+      uint8_t brb = colorLevel(color);
+      for (int16_t yy = 0; yy < h; yy++)
+      {
+        int16_t px = x0 + yy * cx, py = y0 + yy * cy;
+        if (clip && (ay == 0) && ((py < 0) || (py >= page_h))) continue; // row outside of page
+        uint16_t b = yy * w; // bit index of row start, glyph bitmaps are not padded
+        uint8_t bits = pgm_read_byte(&bitmap[bo + b / 8]) << (b % 8);
+        for (int16_t xx = 0; xx < w; xx++, b++, px += ax, py += ay)
+        {
+          if ((xx > 0) && (b % 8 == 0)) bits = pgm_read_byte(&bitmap[bo + b / 8]);
+          bool set = bits & 0x80;
+          bits <<= 1;
+          if (!set) continue;
+          if (clip && ((px < 0) || (px >= int16_t(_pw_w)) || (py < 0) || (py >= page_h))) continue;
+          _writeLevel(px, py, brb);
+        }
+      }
+    }
+
+    // anti-aliased text: GFXfonts are rendered 2x2 supersampled to 4 grey levels, blended with the buffer content
+    // use a font of double size, e.g. FreeSans18pt7b for text of about 9pt; text size is ignored
+    // getTextBounds() doesn't know about the supersampling, its results are double size
+    // 0 : normal text
+    void setTextAntialiasing(GxEPD2_4G_GlyphCache* glyph_cache)
+    {
+      _glyph_cache = glyph_cache;
+      _aa_phase = 0;
+    }
+
+    // print() of GFXfont text uses the anti-aliased glyphs if enabled, else for size 1 the fast drawChar();
+    // Adafruit_GFX::write() would not, drawChar() isn't virtual
+    size_t write(uint8_t c)
+    {
+      if (!gfxFont) return GxEPD2_4G_GFX_BASE_CLASS::write(c);
+      if (!_glyph_cache) return ((textsize_x == 1) && (textsize_y == 1)) ? _writeChar(c) : GxEPD2_4G_GFX_BASE_CLASS::write(c);
+      if (cursor_x != _aa_cursor_x) _aa_phase = 0; // cursor set by application
+      uint8_t y_advance = pgm_read_byte(&gfxFont->yAdvance);
+      if (c == '\n')
+      {
+        cursor_x = 0;
+        cursor_y += y_advance / 2;
+        _aa_phase = 0;
+      }
+      else if (c != '\r')
+      {
+        const GxEPD2_4G_GlyphCache::Glyph* g = _glyph_cache->get(gfxFont, c, _aa_phase);
+        if (g && wrap && g->width && (cursor_x + g->x_offset + g->width > _width))
+        {
+          cursor_x = 0;
+          cursor_y += y_advance / 2;
+          _aa_phase = 0;
+          g = _glyph_cache->get(gfxFont, c, _aa_phase);
+        }
+        if (g)
+        {
+          _drawGlyph(cursor_x + g->x_offset, cursor_y + g->y_offset, *g);
+          uint16_t x2 = _aa_phase + g->x_advance;
+          cursor_x += x2 / 2;
+          _aa_phase = x2 % 2;
+        }
+      }
+      _aa_cursor_x = cursor_x;
+      return 1;
     }
 
     void init(uint32_t serial_diag_bitrate = 0) // = 0 : disabled
@@ -219,6 +417,29 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
       setFullWindow();
     }
 
+    // init after processor deep sleep with the state saved by saveState(), controller not reset, see GxEPD2_4G_EPD
+    // the next update continues with refresh mode and controller memory of before, e.g. a partial update without
+    // the initial full refresh; returns false and does init(serial_diag_bitrate) if the state is not valid
+    bool init(uint32_t serial_diag_bitrate, const GxEPD2_4G_EPD::State& state)
+    {
+      bool restored = epd2.init(serial_diag_bitrate, state);
+      _using_partial_mode = false;
+      _current_page = 0;
+      setFullWindow();
+      if (restored)
+      {
+        setRotation(state.rotation);
+        _mirror = state.gfx_flags & 0x01;
+      }
+      return restored;
+    }
+
+    // state to keep across processor deep sleep, e.g. in RTC memory; save after the last update before sleep
+    void saveState(GxEPD2_4G_EPD::State& state)
+    {
+      epd2.saveState(state, getRotation(), _mirror ? 0x01 : 0x00);
+    }
+
     // release SPI and control pins
     void end()
     {
@@ -227,21 +448,15 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
 
     void fillScreen(uint16_t color) // 0x0 black, >0x0 white, to buffer
     {
-      uint32_t brightness = (uint32_t(color & 0xF800) + uint32_t((color & 0x07E0) << 5) + uint32_t((color & 0x001F) << 11));
-      uint8_t brb = uint8_t((brightness - 1) / 0xC000ul); // GxEPD_LIGHTGREY is one too high
-      uint8_t data = brb * 0b01010101;
-      for (uint16_t x = 0; x < sizeof(_buffer); x++)
-      {
-        _buffer[x] = data;
-      }
+      fillScreenLevel(colorLevel(color));
     }
 
     // display buffer content to screen, useful for full screen buffer
     void display(bool partial_update_mode = false)
     {
-      epd2.writeImage_4G(_buffer, 2, 0, 0, WIDTH, _page_height);
+      _writeImage_4G(0, 0, WIDTH, _page_height);
       epd2.refresh(partial_update_mode);
-      if (!partial_update_mode) epd2.powerOff();
+      if (!partial_update_mode) _powerOffAfterFullRefresh();
     }
 
     // display part of buffer content to screen, useful for full screen buffer
@@ -258,7 +473,7 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
       h = gx_uint16_min(h, height() - y);
       _rotate(x, y, w, h);
       uint16_t y_part = _reverse ? HEIGHT - h - y : y;
-      epd2.writeImagePart_4G(_buffer, 2, x, y_part, GxEPD2_Type::WIDTH, _page_height, x, y_part, w, h);
+      _writeImagePart_4G(x, y_part, GxEPD2_Type::WIDTH, _page_height, x, y_part, w, h);
       epd2.refresh(x, y_part, w, h);
     }
 
@@ -314,7 +529,7 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
         {
           //Serial.print("writeImage("); Serial.print(_pw_x); Serial.print(", "); Serial.print(dest_ys); Serial.print(", ");
           //Serial.print(_pw_w); Serial.print(", "); Serial.print(dest_ye - dest_ys); Serial.println(")");
-          epd2.writeImage_4G(_buffer, 2, _pw_x, dest_ys, _pw_w, dest_ye - dest_ys);
+          _writeImage_4G(_pw_x, dest_ys, _pw_w, dest_ye - dest_ys);
         }
         else
         {
@@ -342,7 +557,7 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
       }
       else // full update
       {
-        epd2.writeImage_4G(_buffer, 2, 0, page_ys, WIDTH, gx_uint16_min(_page_height, HEIGHT - page_ys));
+        _writeImage_4G(0, page_ys, WIDTH, gx_uint16_min(_page_height, HEIGHT - page_ys));
         _current_page++;
         if (_current_page == int16_t(_pages))
         {
@@ -358,7 +573,7 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
             }
             else epd2.refresh(true); // partial update after second phase
           } else epd2.refresh(false); // full update after only phase
-          epd2.powerOff();
+          _powerOffAfterFullRefresh();
           return false;
         }
         fillScreen(GxEPD_WHITE);
@@ -381,7 +596,7 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
           {
             fillScreen(GxEPD_WHITE);
             drawCallback(pv);
-            epd2.writeImage_4G(_buffer, 2, _pw_x, dest_ys, _pw_w, dest_ye - dest_ys);
+            _writeImage_4G(_pw_x, dest_ys, _pw_w, dest_ye - dest_ys);
           }
         }
         epd2.refresh(_pw_x, _pw_y, _pw_w, _pw_h);
@@ -394,7 +609,7 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
           uint16_t page_ys = _current_page * _page_height;
           fillScreen(GxEPD_WHITE);
           drawCallback(pv);
-          epd2.writeImage(_buffer, 0, page_ys, WIDTH, gx_uint16_min(_page_height, HEIGHT - page_ys));
+          _writeImage_4G(0, page_ys, WIDTH, gx_uint16_min(_page_height, HEIGHT - page_ys));
         }
         if (epd2.panel == GxEPD2_4G::GDEW0154Z04)
         { // GxEPD2_154c paged workaround: write color part
@@ -403,133 +618,31 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
             uint16_t page_ys = _current_page * _page_height;
             fillScreen(GxEPD_WHITE);
             drawCallback(pv);
-            epd2.writeImage_4G(_buffer, 2, 0, page_ys, WIDTH, gx_uint16_min(_page_height, HEIGHT - page_ys));
+            _writeImage_4G(0, page_ys, WIDTH, gx_uint16_min(_page_height, HEIGHT - page_ys));
           }
         }
         epd2.refresh(false); // full update
-        epd2.powerOff();
+        _powerOffAfterFullRefresh();
       }
       _current_page = 0;
     }
 
     void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
     {
-      // taken from Adafruit_GFX.cpp, modified
-      int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
-      uint8_t byte = 0;
-      for (int16_t j = 0; j < h; j++)
-      {
-        for (int16_t i = 0; i < w; i++ )
-        {
-          if (i & 7) byte <<= 1;
-          else
-          {
-#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
-            byte = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
-#else
-            byte = bitmap[j * byteWidth + i / 8];
-#endif
-          }
-          if (!(byte & 0x80))
-          {
-            drawPixel(x + i, y + j, color);
-          }
-        }
-      }
+      uint8_t brb = colorLevel(color);
+      _drawPixmapRows(bitmap, 1, x, y, w, h, true, brb);
     }
 
     void drawGreyPixmap(const uint8_t pixmap[], int16_t depth, int16_t x, int16_t y, int16_t w, int16_t h)
     {
-      switch (depth)
-      {
-        case 1:
-          {
-            int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
-            uint8_t byte = 0;
-            for (int16_t j = 0; j < h; j++)
-            {
-              for (int16_t i = 0; i < w; i++ )
-              {
-                if (i & 7) byte <<= 1;
-                else
-                {
-#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
-                  byte = pgm_read_byte(&pixmap[j * byteWidth + i / 8]);
-#else
-                  byte = pixmap[j * byteWidth + i / 8];
-#endif
-                }
-                uint16_t color = byte & 0x80 ? 0xFFFF : 0x0000;
-                drawPixel(x + i, y + j, color);
-              }
-            }
-          }
-          break;
-        case 2:
-          {
-            int16_t byteWidth = (w + 3) / 4; // Bitmap scanline pad = whole byte
-            uint8_t byte = 0;
-            for (int16_t j = 0; j < h; j++)
-            {
-              for (int16_t i = 0; i < w; i++ )
-              {
-                if (i & 3) byte <<= 2;
-                else
-                {
-#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
-                  byte = pgm_read_byte(&pixmap[j * byteWidth + i / 4]);
-#else
-                  byte = pixmap[j * byteWidth + i / 4];
-#endif
-                }
-                drawGreyPixel(x + i, y + j, byte & 0xC0);
-              }
-            }
-          }
-          break;
-        case 4:
-          {
-            int16_t byteWidth = (w + 1) / 2; // Bitmap scanline pad = whole byte
-            uint8_t byte = 0;
-            for (int16_t j = 0; j < h; j++)
-            {
-              for (int16_t i = 0; i < w; i++ )
-              {
-                if (i & 1) byte <<= 4;
-                else
-                {
-#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
-                  byte = pgm_read_byte(&pixmap[j * byteWidth + i / 2]);
-#else
-                  byte = pixmap[j * byteWidth + i / 2];
-#endif
-                }
-                uint8_t grey = byte & 0xF0;
-                if ((grey < 0xF0) && (grey >= 0xA0)) grey = 0x80; // light grey demo limit for 4bpp
-                else if ((grey < 0xF0) && (grey > 0x00)) grey = 0x40;  // dark grey
-                drawGreyPixel(x + i, y + j, grey);
-              }
-            }
-          }
-          break;
-        case 8:
-          {
-            uint8_t byte = 0;
-            for (int16_t j = 0; j < h; j++)
-            {
-              for (int16_t i = 0; i < w; i++ )
-              {
-#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
-                byte = pgm_read_byte(&pixmap[j * w + i]);
-#else
-                byte = pixmap[j * w + i];
-#endif
-                drawGreyPixel(x + i, y + j, byte);
-              }
-            }
-          }
-          break;
-      }
+      if ((depth == 1) || (depth == 2) || (depth == 4) || (depth == 8)) _drawPixmapRows(pixmap, depth, x, y, w, h);
+    }
+
+    // draws a GxEPD2_4G_Canvas at x, y, pixels of grey level transparent_level are not drawn, -1 : none
+    void blit(const GxEPD2_4G_Canvas& canvas, int16_t x, int16_t y, int8_t transparent_level = -1)
+    {
+      if (!canvas.getBuffer()) return;
+      _drawPixmapRows(canvas.getBuffer(), 2, x, y, canvas.bufferWidth(), canvas.bufferHeight(), false, 0, transparent_level, false);
     }
 
     //  Support for Bitmaps (Sprites) to Controller Buffer and to Screen
@@ -637,13 +750,63 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
     void powerOff()
     {
       epd2.powerOff();
+      if (_power_policy) _power_policy->poweredOff();
+    }
+    // power policy for power off after full refresh, 0 : power off after each full refresh
+    void setPowerPolicy(GxEPD2_4G_PowerPolicy* power_policy)
+    {
+      _power_policy = power_policy;
     }
     // turns powerOff() and sets controller to deep sleep for minimum power use, ONLY if wakeable by RST (rst >= 0)
     void hibernate()
     {
       epd2.hibernate();
+      if (_power_policy) _power_policy->poweredOff();
     }
   private:
+    // GFXfont text of size 1 for write(), cursor handling as Adafruit_GFX::write(), glyphs by the fast drawChar()
+    size_t _writeChar(uint8_t c)
+    {
+      uint8_t y_advance = pgm_read_byte(&gfxFont->yAdvance);
+      if (c == '\n')
+      {
+        cursor_x = 0;
+        cursor_y += y_advance;
+      }
+      else if (c != '\r')
+      {
+        uint8_t first = pgm_read_byte(&gfxFont->first);
+        if ((c < first) || (c > (uint8_t)pgm_read_word(&gfxFont->last))) return 1;
+        const GFXglyph* glyph = ((const GFXglyph*)_pgm_read_pointer(&gfxFont->glyph)) + (c - first);
+        int16_t w = pgm_read_byte(&glyph->width);
+        if ((w > 0) && (pgm_read_byte(&glyph->height) > 0))
+        {
+          int16_t xo = int8_t(pgm_read_byte(&glyph->xOffset));
+          if (wrap && (cursor_x + xo + w > _width))
+          {
+            cursor_x = 0;
+            cursor_y += y_advance;
+          }
+          drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, 1, 1);
+        }
+        cursor_x += pgm_read_byte(&glyph->xAdvance);
+      }
+      return 1;
+    }
+    void _powerOffAfterFullRefresh()
+    {
+      if (_power_policy) _power_policy->updated();
+      else epd2.powerOff();
+    }
+    // constants for fixed_rotation, folded by the compiler
+    bool _mirrored()
+    {
+      return (fixed_rotation >= 0) ? fixed_mirror : _mirror;
+    }
+    uint8_t _rotation()
+    {
+      return (fixed_rotation >= 0) ? (fixed_rotation & 3) : getRotation();
+    }
     template <typename T> static inline void
     _swap_(T & a, T & b)
     {
@@ -659,9 +822,223 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
     {
       return (a > b ? a : b);
     };
+    void _drawGlyph(int16_t x, int16_t y, const GxEPD2_4G_GlyphCache::Glyph& g)
+    {
+      if ((g.width == 0) || (g.height == 0)) return;
+      uint8_t fg = colorLevel(textcolor);
+      // glyph origin and steps for next column (ax, ay) and next row (cx, cy) in page buffer coordinates
+      int16_t x0 = x, y0 = y, ax = x + 1, ay = y, cx = x, cy = y + 1;
+      _toPage(x0, y0);
+      _toPage(ax, ay);
+      _toPage(cx, cy);
+      ax -= x0;
+      ay -= y0;
+      cx -= x0;
+      cy -= y0;
+      int16_t page_h = int16_t(_pw_h) - int16_t(_current_page * _page_height); // rows of window on this page
+      if (page_h > int16_t(_page_height)) page_h = _page_height;
+      for (uint8_t yy = 0; yy < g.height; yy++)
+      {
+        int16_t px = x0 + yy * cx, py = y0 + yy * cy;
+        for (uint8_t xx = 0; xx < g.width; xx++, px += ax, py += ay)
+        {
+          if ((px < 0) || (px >= int16_t(_pw_w)) || (py < 0) || (py >= page_h)) continue;
+          uint8_t k = g.coverage(xx, yy);
+          if (k == 0) continue;
+          uint8_t bg = _readLevel(px, py);
+          _writeLevel(px, py, (bg * (3 - k) + fg * k + 1) / 3);
+        }
+      }
+    }
+    // pixmap rows to page buffer, clipped once per row against (partial) window and current page
+    // transparent : 1bpp bitmap, only clear bits are drawn, with grey level ink
+    // key : grey level that is not drawn, -1 : none; pgm : pixmap is in program memory
+    void _drawPixmapRows(const uint8_t pixmap[], int16_t depth, int16_t x, int16_t y, int16_t w, int16_t h,
+                         bool transparent = false, uint8_t ink = 0, int8_t key = -1, bool pgm = true)
+    {
+      if ((w <= 0) || (h <= 0)) return;
+      // pixmap origin and steps for next column (ax, ay) and next row (cx, cy) in page buffer coordinates
+      int16_t x0 = x, y0 = y, ax = x + 1, ay = y, cx = x, cy = y + 1;
+      _toPage(x0, y0);
+      _toPage(ax, ay);
+      _toPage(cx, cy);
+      ax -= x0;
+      ay -= y0;
+      cx -= x0;
+      cy -= y0;
+      int16_t page_h = int16_t(_pw_h) - int16_t(_current_page * _page_height); // rows of window on this page
+      if (page_h > int16_t(_page_height)) page_h = _page_height;
+      int16_t byteWidth = (int32_t(w) * depth + 7) / 8; // Bitmap scanline pad = whole byte
+      uint8_t key_pattern = (key >= 0) ? key * 0b01010101 : 0;
+      for (int16_t j = 0; j < h; j++)
+      {
+        int16_t rx = x0 + j * cx, ry = y0 + j * cy;
+        int16_t i = 0, ie = w;
+        _clipSpan(rx, ax, _pw_w, i, ie);
+        _clipSpan(ry, ay, page_h, i, ie);
+        if (i >= ie) continue;
+        const uint8_t* row = pixmap + int32_t(j) * byteWidth;
+        int16_t px = rx + i * ax, py = ry + i * ay;
+        if (!planar && !transparent && (depth == 2) && (ay == 0))
+        {
+          // 2bpp rows as whole bytes, shifted to the buffer alignment, reversed for rotation 2 or mirror
+          for (; (i < ie) && ((px & 3) != (ax > 0 ? 0 : 3)); i++, px += ax) _drawPixmapPixel(row, i, depth, px, py, false, ink, key, pgm);
+          uint8_t* p = _buffer + px / 4 + py * (_pw_w / 4);
+          uint8_t s = 2 * (i & 3);
+          for (; i + 4 <= ie; i += 4, px += 4 * ax, p += ax)
+          {
+            uint8_t b = _readPixmapByte(row + i / 4, pgm);
+            if (s) b = (b << s) | (_readPixmapByte(row + i / 4 + 1, pgm) >> (8 - s));
+            if (ax < 0) b = ((b & 0x03) << 6) | ((b & 0x0C) << 2) | ((b & 0x30) >> 2) | ((b & 0xC0) >> 6);
+            if (key >= 0)
+            {
+              uint8_t m = b ^ key_pattern; // pixels other than key are not zero
+              m = (m | (m >> 1)) & 0b01010101;
+              m = m * 3;
+              *p = (*p & ~m) | (b & m);
+            }
+            else *p = b;
+          }
+        }
+        for (; i < ie; i++, px += ax, py += ay) _drawPixmapPixel(row, i, depth, px, py, transparent, ink, key, pgm);
+      }
+    }
+    void _drawPixmapPixel(const uint8_t* row, int16_t i, int16_t depth, int16_t px, int16_t py, bool transparent, uint8_t ink, int8_t key, bool pgm)
+    {
+      uint8_t v = ink;
+      if (transparent)
+      {
+        if (_readPixmapByte(row + i / 8, pgm) & (0x80 >> (i % 8))) return;
+      }
+      else
+      {
+        v = _pixmapLevel(row, i, depth, pgm);
+        if (v == key) return;
+      }
+      _writeLevel(px, py, v);
+    }
+    // limits column range [i0, i1) to p + i * step in [0, limit), step is -1, 0 or 1
+    static void _clipSpan(int16_t p, int16_t step, int16_t limit, int16_t& i0, int16_t& i1)
+    {
+      if (step == 0)
+      {
+        if ((p < 0) || (p >= limit)) i1 = i0;
+      }
+      else if (step > 0)
+      {
+        if (-p > i0) i0 = -p;
+        if (limit - p < i1) i1 = limit - p;
+      }
+      else
+      {
+        if (p - limit + 1 > i0) i0 = p - limit + 1;
+        if (p + 1 < i1) i1 = p + 1;
+      }
+    }
+    // grey level 0..3 of pixel i of a pixmap row, same mapping as drawGreyPixel()
+    static uint8_t _pixmapLevel(const uint8_t* row, int16_t i, int16_t depth, bool pgm)
+    {
+      switch (depth)
+      {
+        case 1:
+          return (_readPixmapByte(row + i / 8, pgm) & (0x80 >> (i % 8))) ? 0x03 : 0x00;
+        case 2:
+          return (_readPixmapByte(row + i / 4, pgm) >> (2 * (3 - i % 4))) & 0x03;
+        case 4:
+          {
+            uint8_t grey = (_readPixmapByte(row + i / 2, pgm) << (4 * (i % 2))) & 0xF0;
+            if ((grey < 0xF0) && (grey >= 0xA0)) grey = 0x80; // light grey demo limit for 4bpp
+            else if ((grey < 0xF0) && (grey > 0x00)) grey = 0x40;  // dark grey
+            return grey >> 6;
+          }
+      }
+      return _readPixmapByte(row + i, pgm) >> 6;
+    }
+    static inline uint8_t _readPixmapByte(const uint8_t* p, bool pgm)
+    {
+      if (pgm)
+      {
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+        return pgm_read_byte(p);
+#else
+        return *p;
+#endif
+      }
+      return *p;
+    }
+    // grey level of page buffer pixel, packed or planar
+    void _writeLevel(int16_t px, int16_t py, uint8_t v)
+    {
+      if (planar)
+      {
+        uint16_t i = px / 8 + py * (_pw_w / 8);
+        uint8_t bit = 0x80 >> (px % 8);
+        _buffer[i] = (v & 0x02) ? _buffer[i] | bit : _buffer[i] & ~bit;
+        _buffer[i + _plane_size] = (v & 0x01) ? _buffer[i + _plane_size] | bit : _buffer[i + _plane_size] & ~bit;
+        return;
+      }
+      uint16_t i = px / 4 + py * (_pw_w / 4);
+      uint8_t shift = 2 * (3 - px % 4);
+      _buffer[i] = (_buffer[i] & (0xFF ^ (3 << shift))) | (v << shift);
+    }
+    uint8_t _readLevel(int16_t px, int16_t py)
+    {
+      if (planar)
+      {
+        uint16_t i = px / 8 + py * (_pw_w / 8);
+        uint8_t bit = 0x80 >> (px % 8);
+        return ((_buffer[i] & bit) ? 0x02 : 0x00) | ((_buffer[i + _plane_size] & bit) ? 0x01 : 0x00);
+      }
+      return (_buffer[px / 4 + py * (_pw_w / 4)] >> (2 * (3 - px % 4))) & 0x03;
+    }
+    // page buffer to controller, planar without conversion
+    void _writeImage_4G(int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      if (planar) epd2.writeNativePart_4G(_buffer, _buffer + _plane_size, 0, 0, w, h, x, y, w, h);
+      else epd2.writeImage_4G(_buffer, 2, x, y, w, h);
+    }
+    void _writeImagePart_4G(int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap, int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      if (planar) epd2.writeNativePart_4G(_buffer, _buffer + _plane_size, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h);
+      else epd2.writeImagePart_4G(_buffer, 2, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h);
+    }
+    // logical to page buffer coordinates, without clipping
+    void _toPage(int16_t& x, int16_t& y)
+    {
+      if (_mirrored()) x = width() - x - 1;
+      switch (_rotation())
+      {
+        case 1:
+          _swap_(x, y);
+          x = WIDTH - x - 1;
+          break;
+        case 2:
+          x = WIDTH - x - 1;
+          y = HEIGHT - y - 1;
+          break;
+        case 3:
+          _swap_(x, y);
+          y = HEIGHT - y - 1;
+          break;
+      }
+      x -= _pw_x;
+      if (!_reverse) y -= _pw_y;
+      else y = HEIGHT - _pw_y - y - 1;
+      y -= _current_page * _page_height;
+    }
+    static inline const void* _pgm_read_pointer(const void* addr)
+    {
+#if defined(__AVR)
+      return (const void*)pgm_read_word(addr);
+#elif defined(ESP8266) || defined(ESP32)
+      return (const void*)pgm_read_dword(addr);
+#else
+      return *(const void* const*)addr;
+#endif
+    }
     void _rotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h)
     {
-      switch (getRotation())
+      switch (_rotation())
       {
         case 1:
           _swap_(x, y);
@@ -681,20 +1058,26 @@ class GxEPD2_4G_4G_R : public GxEPD2_4G_GFX_BASE_CLASS
     }
   private:
     uint8_t _buffer[(GxEPD2_Type::WIDTH / 4) * page_height];
-    bool _using_partial_mode, _second_phase, _mirror, _reverse;
+    static const uint16_t _plane_size = (GxEPD2_Type::WIDTH / 8) * page_height;
+    bool _using_partial_mode, _second_phase, _mirror;
+    static const bool _reverse = (GxEPD2_Type::panel == GxEPD2_4G::GDE0213B1);
     uint16_t _width_bytes, _pixel_bytes;
     int16_t _current_page;
+    GxEPD2_4G_PowerPolicy* _power_policy;
+    GxEPD2_4G_GlyphCache* _glyph_cache;
+    int16_t _aa_cursor_x;
+    uint8_t _aa_phase;
     uint16_t _pages, _page_height;
     uint16_t _pw_x, _pw_y, _pw_w, _pw_h;
 };
 
-template<typename GxEPD2_Type, const uint16_t page_height>
-class GxEPD2_4G_4G : public GxEPD2_4G_4G_R<GxEPD2_Type, page_height>
+template<typename GxEPD2_Type, const uint16_t page_height, const int8_t fixed_rotation = -1, const bool fixed_mirror = false, const bool planar = false>
+class GxEPD2_4G_4G : public GxEPD2_4G_4G_R<GxEPD2_Type, page_height, fixed_rotation, fixed_mirror, planar>
 {
   private:
     GxEPD2_Type epd2_copy;
   public:
-    GxEPD2_4G_4G(GxEPD2_Type epd2_instance) : GxEPD2_4G_4G_R<GxEPD2_Type, page_height>(epd2_copy), epd2_copy(epd2_instance)
+    GxEPD2_4G_4G(GxEPD2_Type epd2_instance) : GxEPD2_4G_4G_R<GxEPD2_Type, page_height, fixed_rotation, fixed_mirror, planar>(epd2_copy), epd2_copy(epd2_instance)
     {
     }
 };
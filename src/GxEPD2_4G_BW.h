@@ -31,6 +31,7 @@
 #endif
 
 #include "GxEPD2_4G_EPD.h"
+#include "GxEPD2_4G_PowerPolicy.h"
 
 #if defined __has_include
 #  if __has_include("GxEPD2_4G_EPD.h")
@@ -71,7 +72,9 @@
 #endif
 #include "epd/GxEPD2_750_T7.h"
 
-template<typename GxEPD2_Type, const uint16_t page_height>
+// fixed_rotation 0..3 : rotation and mirror are compile time constants, for faster pixel transforms
+// setRotation() and mirror() have no effect then; -1 (default) : rotation and mirror can be changed at runtime
+template<typename GxEPD2_Type, const uint16_t page_height, const int8_t fixed_rotation = -1, const bool fixed_mirror = false>
 class GxEPD2_4G_BW_R : public GxEPD2_4G_GFX_BASE_CLASS
 {
   public:
@@ -84,10 +87,11 @@ class GxEPD2_4G_BW_R : public GxEPD2_4G_GFX_BASE_CLASS
     {
       _page_height = page_height;
       _pages = (HEIGHT / _page_height) + ((HEIGHT % _page_height) > 0);
-      _reverse = (epd2_instance.panel == GxEPD2_4G::GDE0213B1);
-      _mirror = false;
+      _mirror = fixed_mirror;
+      if (fixed_rotation >= 0) GxEPD2_4G_GFX_BASE_CLASS::setRotation(fixed_rotation);
       _using_partial_mode = false;
       _current_page = 0;
+      _power_policy = 0;
       setFullWindow();
     }
 
@@ -103,16 +107,22 @@ class GxEPD2_4G_BW_R : public GxEPD2_4G_GFX_BASE_CLASS
 
     bool mirror(bool m)
     {
+      if (fixed_rotation >= 0) return fixed_mirror;
       _swap_ (_mirror, m);
       return m;
     }
 
+    void setRotation(uint8_t r)
+    {
+      GxEPD2_4G_GFX_BASE_CLASS::setRotation(fixed_rotation >= 0 ? fixed_rotation : r);
+    }
+
     void drawPixel(int16_t x, int16_t y, uint16_t color)
     {
       if ((x < 0) || (x >= width()) || (y < 0) || (y >= height())) return;
-      if (_mirror) x = width() - x - 1;
+      if (_mirrored()) x = width() - x - 1;
       // check rotation, move pixel around if necessary
-      switch (getRotation())
+      switch (_rotation())
       {
         case 1:
           _swap_(x, y);
@@ -144,6 +154,69 @@ class GxEPD2_4G_BW_R : public GxEPD2_4G_GFX_BASE_CLASS
         _buffer[i] = (_buffer[i] & (0xFF ^ (1 << (7 - x % 8))));
     }
 
+    // fast path for GFXfont text of size 1: glyph bits are written directly to the page buffer
+    // glyphs completely outside of the (partial) window or the current page are skipped
+    using GxEPD2_4G_GFX_BASE_CLASS::drawChar;
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size_x, uint8_t size_y)
+    {
+      if (!gfxFont || (size_x != 1) || (size_y != 1)) return GxEPD2_4G_GFX_BASE_CLASS::drawChar(x, y, c, color, bg, size_x, size_y);
+      uint8_t first = pgm_read_byte(&gfxFont->first);
+      if ((c < first) || (c > (uint8_t)pgm_read_word(&gfxFont->last))) return;
+      const GFXglyph* glyph = ((const GFXglyph*)_pgm_read_pointer(&gfxFont->glyph)) + (c - first);
+      const uint8_t* bitmap = (const uint8_t*)_pgm_read_pointer(&gfxFont->bitmap);
+      uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
+      int16_t w = pgm_read_byte(&glyph->width);
+      int16_t h = pgm_read_byte(&glyph->height);
+      int16_t xo = int8_t(pgm_read_byte(&glyph->xOffset));
+      int16_t yo = int8_t(pgm_read_byte(&glyph->yOffset));
+      if ((w == 0) || (h == 0)) return;
+      // glyph origin and steps for next column (ax, ay) and next row (cx, cy) in page buffer coordinates
+      int16_t x0 = x + xo, y0 = y + yo;
+      int16_t ax = x0 + 1, ay = y0, cx = x0, cy = y0 + 1;
+      _toPage(x0, y0);
+      _toPage(ax, ay);
+      _toPage(cx, cy);
+      ax -= x0;
+      ay -= y0;
+      cx -= x0;
+      cy -= y0;
+      // glyph box in page buffer coordinates, clip once per glyph
+      int16_t x1 = x0 + (w - 1) * ax + (h - 1) * cx;
+      int16_t y1 = y0 + (w - 1) * ay + (h - 1) * cy;
+      int16_t page_h = int16_t(_pw_h) - int16_t(_current_page * _page_height); // rows of window on this page
+      if (page_h > int16_t(_page_height)) page_h = _page_height;
+      int16_t xmin = x0 < x1 ? x0 : x1, xmax = x0 < x1 ? x1 : x0;
+      int16_t ymin = y0 < y1 ? y0 : y1, ymax = y0 < y1 ? y1 : y0;
+      if ((xmax < 0) || (xmin >= int16_t(_pw_w)) || (ymax < 0) || (ymin >= page_h)) return;
+      bool clip = (xmin < 0) || (xmax >= int16_t(_pw_w)) || (ymin < 0) || (ymax >= page_h);
+      bool white = (color == GxEPD_WHITE); // only pure white, use grey as black
+      for (int16_t yy = 0; yy < h; yy++)
+      {
+        int16_t px = x0 + yy * cx, py = y0 + yy * cy;
+        if (clip && (ay == 0) && ((py < 0) || (py >= page_h))) continue; // row outside of page
+        uint16_t b = yy * w; // bit index of row start, glyph bitmaps are not padded
+        uint8_t bits = pgm_read_byte(&bitmap[bo + b / 8]) << (b % 8);
+        for (int16_t xx = 0; xx < w; xx++, b++, px += ax, py += ay)
+        {
+          if ((xx > 0) && (b % 8 == 0)) bits = pgm_read_byte(&bitmap[bo + b / 8]);
+          bool set = bits & 0x80;
+          bits <<= 1;
+          if (!set) continue;
+          if (clip && ((px < 0) || (px >= int16_t(_pw_w)) || (py < 0) || (py >= page_h))) continue;
+          uint16_t i = px / 8 + py * (_pw_w / 8);
+          if (white) _buffer[i] = (_buffer[i] | (1 << (7 - px % 8)));
+          else _buffer[i] = (_buffer[i] & (0xFF ^ (1 << (7 - px % 8))));
+        }
+      }
+    }
+
+    // print() of GFXfont text of size 1 uses the fast drawChar(); Adafruit_GFX::write() would not, drawChar() isn't virtual
+    size_t write(uint8_t c)
+    {
+      if (!gfxFont || (textsize_x != 1) || (textsize_y != 1)) return GxEPD2_4G_GFX_BASE_CLASS::write(c);
+      return _writeChar(c);
+    }
+
     void init(uint32_t serial_diag_bitrate = 0) // = 0 : disabled
     {
       epd2.init(serial_diag_bitrate);
@@ -178,6 +251,29 @@ class GxEPD2_4G_BW_R : public GxEPD2_4G_GFX_BASE_CLASS
       setFullWindow();
     }
 
+    // init after processor deep sleep with the state saved by saveState(), controller not reset, see GxEPD2_4G_EPD
+    // the next update continues with refresh mode and controller memory of before, e.g. a partial update without
+    // the initial full refresh; returns false and does init(serial_diag_bitrate) if the state is not valid
+    bool init(uint32_t serial_diag_bitrate, const GxEPD2_4G_EPD::State& state)
+    {
+      bool restored = epd2.init(serial_diag_bitrate, state);
+      _using_partial_mode = false;
+      _current_page = 0;
+      setFullWindow();
+      if (restored)
+      {
+        setRotation(state.rotation);
+        _mirror = state.gfx_flags & 0x01;
+      }
+      return restored;
+    }
+
+    // state to keep across processor deep sleep, e.g. in RTC memory; save after the last update before sleep
+    void saveState(GxEPD2_4G_EPD::State& state)
+    {
+      epd2.saveState(state, getRotation(), _mirror ? 0x01 : 0x00);
+    }
+
     // release SPI and control pins
     void end()
     {
@@ -203,7 +299,7 @@ class GxEPD2_4G_BW_R : public GxEPD2_4G_GFX_BASE_CLASS
       {
         epd2.writeImageAgain(_buffer, 0, 0, GxEPD2_Type::WIDTH, _page_height);
       }
-      if (!partial_update_mode) epd2.powerOff();
+      if (!partial_update_mode) _powerOffAfterFullRefresh();
     }
 
     // display part of buffer content to screen, useful for full screen buffer
@@ -287,7 +383,7 @@ class GxEPD2_4G_BW_R : public GxEPD2_4G_GFX_BASE_CLASS
             epd2.writeImageAgain(_buffer, 0, 0, GxEPD2_Type::WIDTH, HEIGHT);
             //epd2.refresh(true); // not needed
           }
-          epd2.powerOff();
+          _powerOffAfterFullRefresh();
         }
         return false;
       }
@@ -350,7 +446,7 @@ class GxEPD2_4G_BW_R : public GxEPD2_4G_GFX_BASE_CLASS
             }
             //else epd2.refresh(true); // partial update after second phase
           } else epd2.refresh(false); // full update after only phase
-          epd2.powerOff();
+          _powerOffAfterFullRefresh();
           return false;
         }
         fillScreen(GxEPD_WHITE);
@@ -383,7 +479,7 @@ class GxEPD2_4G_BW_R : public GxEPD2_4G_GFX_BASE_CLASS
           {
             epd2.writeImageAgain(_buffer, 0, 0, GxEPD2_Type::WIDTH, HEIGHT);
             //epd2.refresh(true); // not needed
-            epd2.powerOff();
+            _powerOffAfterFullRefresh();
           }
         }
         return;
@@ -433,7 +529,7 @@ class GxEPD2_4G_BW_R : public GxEPD2_4G_GFX_BASE_CLASS
           }
           //epd2.refresh(true); // partial update after second phase // not needed
         }
-        epd2.powerOff();
+        _powerOffAfterFullRefresh();
       }
       _current_page = 0;
     }
@@ -654,7 +750,7 @@ class GxEPD2_4G_BW_R : public GxEPD2_4G_GFX_BASE_CLASS
     void refresh(bool partial_update_mode = false) // screen refresh from controller memory to full screen
     {
       epd2.refresh(partial_update_mode);
-      if (!partial_update_mode) epd2.powerOff();
+      if (!partial_update_mode) _powerOffAfterFullRefresh();
     }
     void refresh(int16_t x, int16_t y, int16_t w, int16_t h) // screen refresh from controller memory, partial screen
     {
@@ -664,13 +760,63 @@ class GxEPD2_4G_BW_R : public GxEPD2_4G_GFX_BASE_CLASS
     void powerOff()
     {
       epd2.powerOff();
+      if (_power_policy) _power_policy->poweredOff();
+    }
+    // power policy for power off after full refresh, 0 : power off after each full refresh
+    void setPowerPolicy(GxEPD2_4G_PowerPolicy* power_policy)
+    {
+      _power_policy = power_policy;
     }
     // turns powerOff() and sets controller to deep sleep for minimum power use, ONLY if wakeable by RST (rst >= 0)
     void hibernate()
     {
       epd2.hibernate();
+      if (_power_policy) _power_policy->poweredOff();
     }
   private:
+    // GFXfont text of size 1 for write(), cursor handling as Adafruit_GFX::write(), glyphs by the fast drawChar()
+    size_t _writeChar(uint8_t c)
+    {
+      uint8_t y_advance = pgm_read_byte(&gfxFont->yAdvance);
+      if (c == '\n')
+      {
+        cursor_x = 0;
+        cursor_y += y_advance;
+      }
+      else if (c != '\r')
+      {
+        uint8_t first = pgm_read_byte(&gfxFont->first);
+        if ((c < first) || (c > (uint8_t)pgm_read_word(&gfxFont->last))) return 1;
+        const GFXglyph* glyph = ((const GFXglyph*)_pgm_read_pointer(&gfxFont->glyph)) + (c - first);
+        int16_t w = pgm_read_byte(&glyph->width);
+        if ((w > 0) && (pgm_read_byte(&glyph->height) > 0))
+        {
+          int16_t xo = int8_t(pgm_read_byte(&glyph->xOffset));
+          if (wrap && (cursor_x + xo + w > _width))
+          {
+            cursor_x = 0;
+            cursor_y += y_advance;
+          }
+          drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, 1, 1);
+        }
+        cursor_x += pgm_read_byte(&glyph->xAdvance);
+      }
+      return 1;
+    }
+    void _powerOffAfterFullRefresh()
+    {
+      if (_power_policy) _power_policy->updated();
+      else epd2.powerOff();
+    }
+    // constants for fixed_rotation, folded by the compiler
+    bool _mirrored()
+    {
+      return (fixed_rotation >= 0) ? fixed_mirror : _mirror;
+    }
+    uint8_t _rotation()
+    {
+      return (fixed_rotation >= 0) ? (fixed_rotation & 3) : getRotation();
+    }
     template <typename T> static inline void
     _swap_(T & a, T & b)
     {
@@ -686,9 +832,43 @@ class GxEPD2_4G_BW_R : public GxEPD2_4G_GFX_BASE_CLASS
     {
       return (a > b ? a : b);
     };
+    // logical to page buffer coordinates, without clipping
+    void _toPage(int16_t& x, int16_t& y)
+    {
+      if (_mirrored()) x = width() - x - 1;
+      switch (_rotation())
+      {
+        case 1:
+          _swap_(x, y);
+          x = WIDTH - x - 1;
+          break;
+        case 2:
+          x = WIDTH - x - 1;
+          y = HEIGHT - y - 1;
+          break;
+        case 3:
+          _swap_(x, y);
+          y = HEIGHT - y - 1;
+          break;
+      }
+      x -= _pw_x;
+      if (!_reverse) y -= _pw_y;
+      else y = HEIGHT - _pw_y - y - 1;
+      y -= _current_page * _page_height;
+    }
+    static inline const void* _pgm_read_pointer(const void* addr)
+    {
+#if defined(__AVR)
+      return (const void*)pgm_read_word(addr);
+#elif defined(ESP8266) || defined(ESP32)
+      return (const void*)pgm_read_dword(addr);
+#else
+      return *(const void* const*)addr;
+#endif
+    }
     void _rotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h)
     {
-      switch (getRotation())
+      switch (_rotation())
       {
         case 1:
           _swap_(x, y);
@@ -708,20 +888,22 @@ class GxEPD2_4G_BW_R : public GxEPD2_4G_GFX_BASE_CLASS
     }
   private:
     uint8_t _buffer[(GxEPD2_Type::WIDTH / 8) * page_height];
-    bool _using_partial_mode, _second_phase, _mirror, _reverse;
+    bool _using_partial_mode, _second_phase, _mirror;
+    static const bool _reverse = (GxEPD2_Type::panel == GxEPD2_4G::GDE0213B1);
     uint16_t _width_bytes, _pixel_bytes;
     int16_t _current_page;
+    GxEPD2_4G_PowerPolicy* _power_policy;
     uint16_t _pages, _page_height;
     uint16_t _pw_x, _pw_y, _pw_w, _pw_h;
 };
 
-template<typename GxEPD2_Type, const uint16_t page_height>
-class GxEPD2_4G_BW : public GxEPD2_4G_BW_R<GxEPD2_Type, page_height>
+template<typename GxEPD2_Type, const uint16_t page_height, const int8_t fixed_rotation = -1, const bool fixed_mirror = false>
+class GxEPD2_4G_BW : public GxEPD2_4G_BW_R<GxEPD2_Type, page_height, fixed_rotation, fixed_mirror>
 {
   private:
     GxEPD2_Type epd2_copy;
   public:
-    GxEPD2_4G_BW(GxEPD2_Type epd2_instance) : GxEPD2_4G_BW_R<GxEPD2_Type, page_height>(epd2_copy), epd2_copy(epd2_instance)
+    GxEPD2_4G_BW(GxEPD2_Type epd2_instance) : GxEPD2_4G_BW_R<GxEPD2_Type, page_height, fixed_rotation, fixed_mirror>(epd2_copy), epd2_copy(epd2_instance)
     {
     }
 };
@@ -0,0 +1,102 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Job queue for several panels on one SPI bus, writes to one panel while the others refresh.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include "GxEPD2_4G_BusScheduler.h"
+
+GxEPD2_4G_BusScheduler::GxEPD2_4G_BusScheduler()
+{
+  _panel_count = 0;
+  _count = 0;
+}
+
+int8_t GxEPD2_4G_BusScheduler::addPanel(GxEPD2_4G_EPD& epd2, DoneFunction done)
+{
+  if (_panel_count >= max_panels) return -1;
+  Panel& panel = _panel[_panel_count];
+  panel.epd2 = &epd2;
+  panel.done = done;
+  panel.parameter = 0;
+  panel.running = false;
+  return _panel_count++;
+}
+
+bool GxEPD2_4G_BusScheduler::queue(uint8_t panel, WriteFunction write, const void* parameter, bool partial_update_mode)
+{
+  if ((_count >= queue_size) || (panel >= _panel_count)) return false;
+  Job& job = _queue[_count++];
+  job.panel = panel;
+  job.write = write;
+  job.parameter = parameter;
+  job.partial_update_mode = partial_update_mode;
+  return true;
+}
+
+bool GxEPD2_4G_BusScheduler::poll()
+{
+  bool running = false;
+  for (uint8_t i = 0; i < _panel_count; i++)
+  {
+    Panel& panel = _panel[i];
+    if (panel.running)
+    {
+      if (panel.epd2->isBusy())
+      {
+        running = true;
+        continue;
+      }
+      panel.epd2->setDeferredBusyWait(false); // finishes the wait, doesn't block
+      panel.running = false;
+      if (panel.done) panel.done(i, panel.parameter);
+    }
+    for (uint8_t j = 0; j < _count; j++)
+    {
+      if (_queue[j].panel == i)
+      {
+        _start(j); // first queued job of this panel
+        running = true;
+        break;
+      }
+    }
+  }
+  return running || (_count > 0);
+}
+
+void GxEPD2_4G_BusScheduler::run()
+{
+  while (poll())
+  {
+    delay(1);
+#if defined(ESP8266) || defined(ESP32)
+    yield(); // avoid wdt
+#endif
+  }
+}
+
+bool GxEPD2_4G_BusScheduler::isBusy(uint8_t panel)
+{
+  return (panel < _panel_count) && _panel[panel].running;
+}
+
+void GxEPD2_4G_BusScheduler::_start(uint8_t index)
+{
+  Job job = _queue[index];
+  for (uint8_t j = index + 1; j < _count; j++)
+  {
+    _queue[j - 1] = _queue[j];
+  }
+  _count--;
+  Panel& panel = _panel[job.panel];
+  panel.epd2->setDeferredBusyWait(true);
+  if (job.write) job.write(*panel.epd2, job.parameter);
+  panel.epd2->refresh(job.partial_update_mode);
+  panel.parameter = job.parameter;
+  panel.running = true;
+}
@@ -0,0 +1,65 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Job queue for several panels on one SPI bus, writes to one panel while the others refresh.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#ifndef _GxEPD2_4G_BusScheduler_H_
+#define _GxEPD2_4G_BusScheduler_H_
+
+#include "GxEPD2_4G_EPD.h"
+
+// panels share SPI (MOSI, SCK) and have their own CS, DC, RST and BUSY pins
+// a job is a write function that streams controller memory of one panel, followed by a refresh of that panel
+// jobs of a panel run in queue order; a job starts when its panel is idle, the refresh returns without waiting,
+// by setDeferredBusyWait(), so the bus is free for the jobs of other panels while the panel is busy
+// completion is reported per panel, by the done callback of addPanel(), when the panel is no longer busy
+class GxEPD2_4G_BusScheduler
+{
+  public:
+    static const uint8_t max_panels = 4;
+    static const uint8_t queue_size = 8; // jobs of all panels
+    typedef void (*WriteFunction)(GxEPD2_4G_EPD& epd2, const void* parameter); // e.g. writeImage_4G()
+    typedef void (*DoneFunction)(uint8_t panel, const void* parameter); // parameter of the job done
+    GxEPD2_4G_BusScheduler();
+    // returns the panel index, or -1 if max_panels reached
+    int8_t addPanel(GxEPD2_4G_EPD& epd2, DoneFunction done = 0);
+    // returns false if the queue is full or panel is invalid; write may be 0 for a refresh only
+    bool queue(uint8_t panel, WriteFunction write, const void* parameter = 0, bool partial_update_mode = false);
+    // reports finished refreshes and starts jobs of idle panels; call from loop()
+    // returns true while jobs are queued or refreshes are running
+    bool poll();
+    void run(); // polls until all jobs are done
+    uint8_t queued()
+    {
+      return _count;
+    };
+    bool isBusy(uint8_t panel); // refresh of a job running
+  private:
+    struct Job
+    {
+      uint8_t panel;
+      WriteFunction write;
+      const void* parameter;
+      bool partial_update_mode;
+    };
+    struct Panel
+    {
+      GxEPD2_4G_EPD* epd2;
+      DoneFunction done;
+      const void* parameter; // of the running job
+      bool running;
+    };
+    void _start(uint8_t index);
+  private:
+    Panel _panel[max_panels];
+    Job _queue[queue_size];
+    uint8_t _panel_count, _count;
+};
+
+#endif
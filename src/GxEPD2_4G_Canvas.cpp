@@ -0,0 +1,78 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Off-screen 2bpp canvas for sprites, drawn to the page buffer by GxEPD2_4G_4G_R::blit().
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include "GxEPD2_4G_Canvas.h"
+
+GxEPD2_4G_Canvas::GxEPD2_4G_Canvas(uint16_t w, uint16_t h) : Adafruit_GFX(w, h)
+{
+  _width_bytes = (w + 3) / 4;
+  _buffer = (uint8_t*) malloc(uint32_t(_width_bytes) * h);
+  fillScreenLevel(3);
+}
+
+GxEPD2_4G_Canvas::~GxEPD2_4G_Canvas()
+{
+  if (_buffer) free(_buffer);
+}
+
+void GxEPD2_4G_Canvas::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+  drawPixelLevel(x, y, GxEPD2_4G::colorLevel(color));
+}
+
+void GxEPD2_4G_Canvas::drawPixelLevel(int16_t x, int16_t y, uint8_t level)
+{
+  if (!_toBuffer(x, y)) return;
+  uint16_t i = x / 4 + y * _width_bytes;
+  uint8_t shift = 2 * (3 - x % 4);
+  _buffer[i] = (_buffer[i] & (0xFF ^ (3 << shift))) | ((level & 0x03) << shift);
+}
+
+uint8_t GxEPD2_4G_Canvas::getPixelLevel(int16_t x, int16_t y) const
+{
+  if (!_toBuffer(x, y)) return 0;
+  return (_buffer[x / 4 + y * _width_bytes] >> (2 * (3 - x % 4))) & 0x03;
+}
+
+void GxEPD2_4G_Canvas::fillScreen(uint16_t color)
+{
+  fillScreenLevel(GxEPD2_4G::colorLevel(color));
+}
+
+void GxEPD2_4G_Canvas::fillScreenLevel(uint8_t level)
+{
+  if (!_buffer) return;
+  memset(_buffer, (level & 0x03) * 0b01010101, uint32_t(_width_bytes) * HEIGHT);
+}
+
+bool GxEPD2_4G_Canvas::_toBuffer(int16_t& x, int16_t& y) const
+{
+  if (!_buffer || (x < 0) || (x >= width()) || (y < 0) || (y >= height())) return false;
+  int16_t t;
+  switch (getRotation())
+  {
+    case 1:
+      t = x;
+      x = WIDTH - 1 - y;
+      y = t;
+      break;
+    case 2:
+      x = WIDTH - 1 - x;
+      y = HEIGHT - 1 - y;
+      break;
+    case 3:
+      t = x;
+      x = y;
+      y = HEIGHT - 1 - t;
+      break;
+  }
+  return true;
+}
@@ -0,0 +1,51 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Off-screen 2bpp canvas for sprites, drawn to the page buffer by GxEPD2_4G_4G_R::blit().
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#ifndef _GxEPD2_4G_Canvas_H_
+#define _GxEPD2_4G_Canvas_H_
+
+#include <Adafruit_GFX.h>
+#include "GxEPD2_4G.h"
+
+// same bit layout as the page buffer of GxEPD2_4G_4G_R, 4 pixels per byte, first pixel in high bits
+// level 0 : black, 1 : dark grey, 2 : light grey, 3 : white; rows are padded to whole bytes
+// the buffer is allocated by the constructor, like GFXcanvas of Adafruit_GFX; check getBuffer() for 0
+class GxEPD2_4G_Canvas : public Adafruit_GFX
+{
+  public:
+    GxEPD2_4G_Canvas(uint16_t w, uint16_t h);
+    ~GxEPD2_4G_Canvas();
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+    void drawPixelLevel(int16_t x, int16_t y, uint8_t level);
+    uint8_t getPixelLevel(int16_t x, int16_t y) const;
+    void fillScreen(uint16_t color);
+    void fillScreenLevel(uint8_t level);
+    uint8_t* getBuffer() const
+    {
+      return _buffer;
+    };
+    // size of buffer content, independent of rotation
+    uint16_t bufferWidth() const
+    {
+      return WIDTH;
+    };
+    uint16_t bufferHeight() const
+    {
+      return HEIGHT;
+    };
+  private:
+    bool _toBuffer(int16_t& x, int16_t& y) const;
+  private:
+    uint8_t* _buffer;
+    uint16_t _width_bytes;
+};
+
+#endif
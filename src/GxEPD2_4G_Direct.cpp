@@ -0,0 +1,238 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Bufferless 4 grey level drawing, primitives are written directly to controller memory.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include "GxEPD2_4G_Direct.h"
+
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+#define GxEPD2_4G_read_byte(addr) pgm_read_byte(addr)
+#define GxEPD2_4G_read_word(addr) pgm_read_word(addr)
+#else
+#define GxEPD2_4G_read_byte(addr) (*(const uint8_t*)(addr))
+#define GxEPD2_4G_read_word(addr) (*(const uint16_t*)(addr))
+#endif
+
+static inline const void* GxEPD2_4G_read_pointer(const void* addr)
+{
+#if defined(__AVR)
+  return (const void*)pgm_read_word(addr);
+#elif defined(ESP8266) || defined(ESP32)
+  return (const void*)pgm_read_dword(addr);
+#else
+  return *(const void* const*)addr;
+#endif
+}
+
+GxEPD2_4G_Direct::GxEPD2_4G_Direct(GxEPD2_4G_EPD& epd2) : _epd2(epd2)
+{
+  _background = 3;
+  _merge = false;
+  _windows_written = 0;
+  _level = 3;
+  _pixmap = 0;
+  _depth = 0;
+  _pgm = false;
+  _text = 0;
+  _font = 0;
+}
+
+void GxEPD2_4G_Direct::clear(uint8_t level)
+{
+  _background = level & 0x03;
+  _px = 0;
+  _py = 0;
+  _pw = _epd2.WIDTH;
+  _ph = _epd2.HEIGHT;
+  _level = _background;
+  _render(rect_primitive, 0, 0, _epd2.WIDTH, _epd2.HEIGHT);
+}
+
+void GxEPD2_4G_Direct::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t level)
+{
+  _px = x;
+  _py = y;
+  _pw = w;
+  _ph = h;
+  _level = level & 0x03;
+  _render(rect_primitive, x, y, w, h);
+}
+
+void GxEPD2_4G_Direct::drawGreyPixmap(const uint8_t pixmap[], int16_t depth, int16_t x, int16_t y, int16_t w, int16_t h, bool pgm)
+{
+  if ((depth != 1) && (depth != 2) && (depth != 4) && (depth != 8)) return;
+  _px = x;
+  _py = y;
+  _pw = w;
+  _ph = h;
+  _pixmap = pixmap;
+  _depth = depth;
+  _pgm = pgm;
+  _render(pixmap_primitive, x, y, w, h);
+}
+
+int16_t GxEPD2_4G_Direct::drawText(int16_t x, int16_t y, const char* text, const GFXfont* font, uint8_t level)
+{
+  if (!font || !text) return x;
+  uint8_t first = GxEPD2_4G_read_byte(&font->first);
+  uint8_t last = GxEPD2_4G_read_word(&font->last);
+  const GFXglyph* glyphs = (const GFXglyph*)GxEPD2_4G_read_pointer(&font->glyph);
+  // text box
+  int16_t cx = x, x1 = 0x7FFF, y1 = 0x7FFF, x2 = -0x7FFF, y2 = -0x7FFF;
+  for (const char* c = text; *c; c++)
+  {
+    uint8_t code = *c;
+    if ((code < first) || (code > last)) continue;
+    const GFXglyph* glyph = glyphs + (code - first);
+    uint8_t w = GxEPD2_4G_read_byte(&glyph->width);
+    uint8_t h = GxEPD2_4G_read_byte(&glyph->height);
+    int16_t xo = int8_t(GxEPD2_4G_read_byte(&glyph->xOffset));
+    int16_t yo = int8_t(GxEPD2_4G_read_byte(&glyph->yOffset));
+    if (w && h)
+    {
+      if (cx + xo < x1) x1 = cx + xo;
+      if (cx + xo + w > x2) x2 = cx + xo + w;
+      if (y + yo < y1) y1 = y + yo;
+      if (y + yo + h > y2) y2 = y + yo + h;
+    }
+    cx += GxEPD2_4G_read_byte(&glyph->xAdvance);
+  }
+  if (x1 >= x2) return cx;
+  _px = x;
+  _py = y;
+  _text = text;
+  _font = font;
+  _level = level & 0x03;
+  _render(text_primitive, x1, y1, x2 - x1, y2 - y1);
+  return cx;
+}
+
+void GxEPD2_4G_Direct::_render(Primitive primitive, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  int16_t x1 = x < 0 ? 0 : x;
+  int16_t y1 = y < 0 ? 0 : y;
+  int16_t x2 = x + w < int16_t(_epd2.WIDTH) ? x + w : _epd2.WIDTH;
+  int16_t y2 = y + h < int16_t(_epd2.HEIGHT) ? y + h : _epd2.HEIGHT;
+  if ((x1 >= x2) || (y1 >= y2)) return;
+  x1 -= x1 % 8; // byte boundary on controller
+  x2 += (8 - x2 % 8) % 8;
+  int16_t wb = (x2 - x1) / 8;
+  if (wb > int16_t(scratch_size)) return; // scratch_size too small for this panel
+  int16_t rows = scratch_size / wb;
+  for (int16_t ys = y1; ys < y2; ys += rows)
+  {
+    _renderStrip(primitive, x1, ys, wb, y2 - ys < rows ? y2 - ys : rows);
+  }
+}
+
+void GxEPD2_4G_Direct::_renderStrip(Primitive primitive, int16_t xs, int16_t ys, int16_t wb, int16_t hs)
+{
+  _sx = xs;
+  _sy = ys;
+  _swb = wb;
+  _sh = hs;
+  int16_t xe = xs + 8 * wb, ye = ys + hs;
+  bool covered = (primitive != text_primitive) && (_px <= xs) && (_px + _pw >= xe);
+  if (covered || !_merge || !_epd2.readNativePart_4G(_plane1, _plane2, xs, ys, 8 * wb, hs))
+  {
+    memset(_plane1, (_background & 0x02) ? 0xFF : 0x00, wb * hs);
+    memset(_plane2, (_background & 0x01) ? 0xFF : 0x00, wb * hs);
+  }
+  switch (primitive)
+  {
+    case rect_primitive:
+      {
+        int16_t x1 = _px > xs ? _px : xs, x2 = _px + _pw < xe ? _px + _pw : xe;
+        int16_t y1 = _py > ys ? _py : ys, y2 = _py + _ph < ye ? _py + _ph : ye;
+        for (int16_t y = y1; y < y2; y++)
+        {
+          for (int16_t x = x1; x < x2; x++) _setLevel(x - xs, y - ys, _level);
+        }
+      }
+      break;
+    case pixmap_primitive:
+      {
+        int16_t byteWidth = (int32_t(_pw) * _depth + 7) / 8; // Bitmap scanline pad = whole byte
+        int16_t j1 = ys - _py > 0 ? ys - _py : 0, j2 = ye - _py < _ph ? ye - _py : _ph;
+        int16_t i1 = xs - _px > 0 ? xs - _px : 0, i2 = xe - _px < _pw ? xe - _px : _pw;
+        for (int16_t j = j1; j < j2; j++)
+        {
+          const uint8_t* row = _pixmap + int32_t(j) * byteWidth;
+          for (int16_t i = i1; i < i2; i++)
+          {
+            uint8_t level;
+            switch (_depth)
+            {
+              case 1:
+                level = ((_pgm ? GxEPD2_4G_read_byte(row + i / 8) : row[i / 8]) & (0x80 >> (i % 8))) ? 0x03 : 0x00;
+                break;
+              case 2:
+                level = ((_pgm ? GxEPD2_4G_read_byte(row + i / 4) : row[i / 4]) >> (2 * (3 - i % 4))) & 0x03;
+                break;
+              case 4:
+                {
+                  uint8_t grey = ((_pgm ? GxEPD2_4G_read_byte(row + i / 2) : row[i / 2]) << (4 * (i % 2))) & 0xF0;
+                  if ((grey < 0xF0) && (grey >= 0xA0)) grey = 0x80; // light grey demo limit for 4bpp
+                  else if ((grey < 0xF0) && (grey > 0x00)) grey = 0x40;  // dark grey
+                  level = grey >> 6;
+                }
+                break;
+              default:
+                level = (_pgm ? GxEPD2_4G_read_byte(row + i) : row[i]) >> 6;
+            }
+            _setLevel(_px + i - xs, _py + j - ys, level);
+          }
+        }
+      }
+      break;
+    case text_primitive:
+      {
+        uint8_t first = GxEPD2_4G_read_byte(&_font->first);
+        uint8_t last = GxEPD2_4G_read_word(&_font->last);
+        const GFXglyph* glyphs = (const GFXglyph*)GxEPD2_4G_read_pointer(&_font->glyph);
+        const uint8_t* bitmap = (const uint8_t*)GxEPD2_4G_read_pointer(&_font->bitmap);
+        int16_t cx = _px;
+        for (const char* c = _text; *c; c++)
+        {
+          uint8_t code = *c;
+          if ((code < first) || (code > last)) continue;
+          const GFXglyph* glyph = glyphs + (code - first);
+          uint16_t bo = GxEPD2_4G_read_word(&glyph->bitmapOffset);
+          int16_t w = GxEPD2_4G_read_byte(&glyph->width);
+          int16_t h = GxEPD2_4G_read_byte(&glyph->height);
+          int16_t gx = cx + int8_t(GxEPD2_4G_read_byte(&glyph->xOffset));
+          int16_t gy = _py + int8_t(GxEPD2_4G_read_byte(&glyph->yOffset));
+          cx += GxEPD2_4G_read_byte(&glyph->xAdvance);
+          if ((gx >= xe) || (gx + w <= xs) || (gy >= ye) || (gy + h <= ys)) continue; // not in strip
+          int16_t yy1 = ys - gy > 0 ? ys - gy : 0, yy2 = ye - gy < h ? ye - gy : h;
+          for (int16_t yy = yy1; yy < yy2; yy++)
+          {
+            for (int16_t xx = 0; xx < w; xx++)
+            {
+              uint16_t b = yy * w + xx; // glyph bitmaps are not padded
+              if (!(GxEPD2_4G_read_byte(&bitmap[bo + b / 8]) & (0x80 >> (b % 8)))) continue;
+              int16_t x = gx + xx;
+              if ((x >= xs) && (x < xe)) _setLevel(x - xs, gy + yy - ys, _level);
+            }
+          }
+        }
+      }
+      break;
+  }
+  _epd2.writeNativePart_4G(_plane1, _plane2, 0, 0, 8 * wb, hs, xs, ys, 8 * wb, hs);
+  _windows_written++;
+}
+
+void GxEPD2_4G_Direct::_setLevel(int16_t x, int16_t y, uint8_t level)
+{
+  uint16_t i = x / 8 + y * _swb;
+  uint8_t bit = 0x80 >> (x % 8);
+  _plane1[i] = (level & 0x02) ? _plane1[i] | bit : _plane1[i] & ~bit;
+  _plane2[i] = (level & 0x01) ? _plane2[i] | bit : _plane2[i] & ~bit;
+}
@@ -0,0 +1,70 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Bufferless 4 grey level drawing, primitives are written directly to controller memory.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#ifndef _GxEPD2_4G_Direct_H_
+#define _GxEPD2_4G_Direct_H_
+
+#include <Adafruit_GFX.h>
+#include "GxEPD2_4G_EPD.h"
+
+// for processors with too little RAM for a page buffer, e.g. screens made of boxes, bitmaps and text
+// each primitive is rendered in strips of a small scratch buffer and written as controller window by writeNativePart_4G()
+// pixels of the 8 pixel wide byte columns at the left and right edges of a primitive are written with the
+// background level of clear(), unless merged with controller memory read back, see setMerge()
+// coordinates are controller coordinates, no rotation; grey level 0 : black, 1 : dark grey, 2 : light grey, 3 : white
+// the levels are rendered to the planes of writeNativePart_4G(), the driver converts them to controller polarity
+class GxEPD2_4G_Direct
+{
+  public:
+    static const uint16_t scratch_size = 128; // bytes per plane, at least WIDTH / 8
+    GxEPD2_4G_Direct(GxEPD2_4G_EPD& epd2);
+    void clear(uint8_t level = 3); // fills controller memory and sets the background level
+    // merge partly covered strips with controller memory, if readNativePart_4G() is supported, e.g. SSD16xx with setReadPins()
+    void setMerge(bool merge)
+    {
+      _merge = merge;
+    };
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t level);
+    // depth 1, 2, 4 or 8, same grey mapping as drawGreyPixmap() of GxEPD2_4G_4G
+    void drawGreyPixmap(const uint8_t pixmap[], int16_t depth, int16_t x, int16_t y, int16_t w, int16_t h, bool pgm = true);
+    // text of GFXfont, y is the baseline; the text box is one primitive; returns x after the text
+    int16_t drawText(int16_t x, int16_t y, const char* text, const GFXfont* font, uint8_t level);
+    void refresh(bool partial_update_mode = false)
+    {
+      _epd2.refresh(partial_update_mode);
+    };
+    uint32_t windowsWritten()
+    {
+      return _windows_written;
+    };
+  private:
+    enum Primitive {rect_primitive, pixmap_primitive, text_primitive};
+    void _render(Primitive primitive, int16_t x, int16_t y, int16_t w, int16_t h);
+    void _renderStrip(Primitive primitive, int16_t xs, int16_t ys, int16_t wb, int16_t hs);
+    void _setLevel(int16_t x, int16_t y, uint8_t level); // scratch coordinates
+  private:
+    GxEPD2_4G_EPD& _epd2;
+    uint8_t _background;
+    bool _merge;
+    uint32_t _windows_written;
+    uint8_t _plane1[scratch_size], _plane2[scratch_size];
+    int16_t _sx, _sy, _swb, _sh; // current strip, controller coordinates, width bytes
+    // current primitive
+    int16_t _px, _py, _pw, _ph;
+    uint8_t _level;
+    const uint8_t* _pixmap;
+    int16_t _depth;
+    bool _pgm;
+    const char* _text;
+    const GFXfont* _font;
+};
+
+#endif
@@ -18,9 +18,9 @@
 #endif
 
 GxEPD2_4G_EPD::GxEPD2_4G_EPD(int16_t cs, int16_t dc, int16_t rst, int16_t busy, int16_t busy_level, uint32_t busy_timeout,
-                       uint16_t w, uint16_t h, GxEPD2_4G::Panel p, bool c, bool pu, bool fpu) :
-  WIDTH(w), HEIGHT(h), panel(p), hasColor(c), hasPartialUpdate(pu), hasFastPartialUpdate(fpu),
-  _cs(cs), _dc(dc), _rst(rst), _busy(busy), _busy_level(busy_level), _busy_timeout(busy_timeout), _diag_enabled(false),
+                       uint16_t w, uint16_t h, GxEPD2_4G::Panel p, bool c, bool pu, bool fpu, bool pw4g) :
+  WIDTH(w), HEIGHT(h), panel(p), hasColor(c), hasPartialUpdate(pu), hasFastPartialUpdate(fpu), hasPartialUpdateWindow_4G(pw4g),
+  _cs(cs), _dc(dc), _rst(rst), _busy(busy), _busy_level(busy_level), _sda(-1), _sck(-1), _busy_timeout(busy_timeout), _diag_enabled(false),
   _pSPIx(&SPI), _spi_settings(4000000, MSBFIRST, SPI_MODE0)
 {
   _initial_write = true;
@@ -33,6 +33,32 @@ GxEPD2_4G_EPD::GxEPD2_4G_EPD(int16_t cs, int16_t dc, int16_t rst, int16_t busy,
   _reset_duration = 10;
   _busy_callback = 0;
   _busy_callback_parameter = 0;
+  _trace = 0;
+  _lut_uploads = 0;
+  _lut_uploads_skipped = 0;
+  _lut_sets[lut_full] = 0;
+  _lut_sets[lut_grey] = 0;
+  _lut_sets[lut_partial] = 0;
+  _lut_sets[lut_grey_fast] = 0;
+  _lut_registry_count = 0;
+  _fast_grey_max = 0;
+  _fast_grey_count = 0;
+  _temperature = temperature_unknown;
+  _fast_full_min_temperature = 1;
+  _fast_full_max_temperature = 0;
+  _temperature_interval = 0;
+  _temperature_time = 0;
+  _busy_wait_deferred = false;
+  _busy_wait_pending = false;
+  _busy_comment = 0;
+  _busy_time = 0;
+  _busy_start = 0;
+  _adaptive_busy_wait = false;
+  _busy_timing_count = 0;
+  _busy_polls = 0;
+  _energy_figures = 0;
+  resetEnergy();
+  _invalidateLuts();
 }
 
 void GxEPD2_4G_EPD::init(uint32_t serial_diag_bitrate)
@@ -50,7 +76,82 @@ void GxEPD2_4G_EPD::init(uint32_t serial_diag_bitrate, bool initial, uint16_t re
   _hibernating = false;
   _init_display_done = false;
   _init_4G_done = false;
+  _invalidateLuts();
   _reset_duration = reset_duration;
+  _initPins(serial_diag_bitrate, true);
+}
+
+void GxEPD2_4G_EPD::saveState(State& state, uint8_t rotation, uint8_t gfx_flags)
+{
+  finishBusyWait();
+  memset(&state, 0, sizeof(state));
+  state.version = State::current_version;
+  state.panel = panel;
+  state.width = WIDTH;
+  state.height = HEIGHT;
+  state.flags = (_initial_write ? State::initial_write : 0) | (_initial_refresh ? State::initial_refresh : 0) |
+                (_power_is_on ? State::power_is_on : 0) | (_using_partial_mode ? State::using_partial_mode : 0) |
+                (_hibernating ? State::hibernating : 0) | (_init_display_done ? State::init_display_done : 0) |
+                (_init_4G_done ? State::init_4G_done : 0) | (_pulldown_rst_mode ? State::pulldown_rst_mode : 0);
+  state.driver_state = _saveDriverState();
+  state.fast_grey_count = _fast_grey_count;
+  state.reset_duration = _reset_duration;
+  state.temperature = _temperature;
+  state.rotation = rotation;
+  state.gfx_flags = gfx_flags;
+  for (uint8_t i = 0; i < lut_cache_size; i++)
+  {
+    state.lut_command[i] = _lut_command[i];
+    state.lut_loaded[i] = _lut_loaded[i];
+  }
+  state.check = _stateCheck(state);
+}
+
+bool GxEPD2_4G_EPD::init(uint32_t serial_diag_bitrate, const State& state)
+{
+  if ((state.version != State::current_version) || (state.panel != panel) || (state.width != WIDTH) || (state.height != HEIGHT) ||
+      (state.check != _stateCheck(state)))
+  {
+    init(serial_diag_bitrate); // e.g. after power loss, RTC memory not valid
+    return false;
+  }
+  _initial_write = state.flags & State::initial_write;
+  _initial_refresh = state.flags & State::initial_refresh;
+  _power_is_on = state.flags & State::power_is_on;
+  _using_partial_mode = state.flags & State::using_partial_mode;
+  _hibernating = state.flags & State::hibernating;
+  _init_display_done = state.flags & State::init_display_done;
+  _init_4G_done = state.flags & State::init_4G_done;
+  _pulldown_rst_mode = state.flags & State::pulldown_rst_mode;
+  _restoreDriverState(state.driver_state);
+  _fast_grey_count = state.fast_grey_count;
+  _reset_duration = state.reset_duration;
+  _temperature = state.temperature;
+  _temperature_time = millis();
+  for (uint8_t i = 0; i < lut_cache_size; i++)
+  {
+    _lut_command[i] = state.lut_command[i];
+    _lut_loaded[i] = state.lut_loaded[i];
+  }
+  _initPins(serial_diag_bitrate, false);
+  return true;
+}
+
+uint16_t GxEPD2_4G_EPD::_stateCheck(const State& state)
+{
+  const uint8_t* p = (const uint8_t*) &state;
+  const uint8_t* c = (const uint8_t*) &state.check;
+  uint16_t check = 0x4758; // not 0 for all zero
+  for (uint16_t i = 0; i < sizeof(State); i++)
+  {
+    if ((p + i >= c) && (p + i < c + sizeof(state.check))) continue;
+    check = (check << 1 | check >> 15) ^ p[i];
+  }
+  return check;
+}
+
+void GxEPD2_4G_EPD::_initPins(uint32_t serial_diag_bitrate, bool reset)
+{
   if (serial_diag_bitrate > 0)
   {
     Serial.begin(serial_diag_bitrate);
@@ -62,7 +163,7 @@ void GxEPD2_4G_EPD::init(uint32_t serial_diag_bitrate, bool initial, uint16_t re
     pinMode(_cs, OUTPUT);
     digitalWrite(_cs, HIGH); // set (needed e.g. for RP2040)
   }
-  _reset();
+  if (reset) _reset();
   _pSPIx->begin(); // may steal _rst pin (Waveshare Pico-ePaper-2.9)
   if (_rst >= 0)
   {
@@ -108,10 +209,166 @@ void GxEPD2_4G_EPD::selectSPI(SPIClass& spi, SPISettings spi_settings)
   _spi_settings = spi_settings;
 }
 
+void GxEPD2_4G_EPD::setReadPins(int16_t sda, int16_t sck)
+{
+  _sda = sda;
+  _sck = sck;
+}
+
+bool GxEPD2_4G_EPD::_canRead()
+{
+  if ((_sda < 0) || (_sck < 0) || _hibernating) return false;
+#if defined(ESP32)
+  return true;
+#else
+  return (_pSPIx == &SPI) && (_sda == MOSI) && (_sck == SCK); // SPI begin() after the read restores only these
+#endif
+}
+
+int8_t GxEPD2_4G_EPD::registerLutSet(LutMode mode, const LutSet* lut_set)
+{
+  if ((_lut_registry_count >= lut_registry_size) || !lut_set) return -1;
+  _lut_registry[_lut_registry_count] = lut_set;
+  _lut_registry_mode[_lut_registry_count] = mode;
+  return _lut_registry_count++;
+}
+
+bool GxEPD2_4G_EPD::selectLutSet(uint8_t index)
+{
+  if (index >= _lut_registry_count) return false;
+  return setLutSet(_lut_registry_mode[index], _lut_registry[index]);
+}
+
+int8_t GxEPD2_4G_EPD::selectLutSet(LutMode mode, uint16_t max_refresh_time)
+{
+  int8_t best = -1;
+  for (uint8_t i = 0; i < _lut_registry_count; i++)
+  {
+    if ((_lut_registry_mode[i] != mode) || (_lut_registry[i]->refresh_time > max_refresh_time)) continue;
+    if ((best < 0) || (_lut_registry[i]->refresh_time > _lut_registry[best]->refresh_time)) best = i;
+  }
+  if ((best < 0) || !selectLutSet(best)) return -1;
+  return best;
+}
+
+uint16_t GxEPD2_4G_EPD::lutRefreshTime(LutMode mode)
+{
+  return (mode <= lut_grey_fast) && _lut_sets[mode] ? _lut_sets[mode]->refresh_time : 0;
+}
+
+void GxEPD2_4G_EPD::setTemperatureInterval(uint32_t interval_ms)
+{
+  _temperature_interval = interval_ms;
+}
+
+void GxEPD2_4G_EPD::setTemperature(int16_t celsius)
+{
+  _temperature = celsius;
+  _temperature_time = millis();
+}
+
+int16_t GxEPD2_4G_EPD::getTemperature()
+{
+  if ((_temperature_interval > 0) && ((_temperature == temperature_unknown) || (millis() - _temperature_time >= _temperature_interval)))
+  {
+    int16_t celsius;
+    if (_readTemperature(celsius)) setTemperature(celsius);
+  }
+  return _temperature;
+}
+
+void GxEPD2_4G_EPD::setFastFullUpdateRange(int16_t min_celsius, int16_t max_celsius)
+{
+  _fast_full_min_temperature = min_celsius;
+  _fast_full_max_temperature = max_celsius;
+}
+
+void GxEPD2_4G_EPD::setFastGreyRefresh(uint8_t max_count)
+{
+  _fast_grey_max = max_count;
+}
+
+bool GxEPD2_4G_EPD::_useFastGrey(uint16_t w, uint16_t h)
+{
+  if (_fast_grey_count >= _fast_grey_max) return false;
+  if (2 * uint32_t(w) * h > uint32_t(WIDTH) * HEIGHT) return false;
+  _fast_grey_count++;
+  return true;
+}
+
+bool GxEPD2_4G_EPD::_useFastFullUpdate(bool compiled)
+{
+  if (_fast_full_min_temperature > _fast_full_max_temperature) return compiled;
+  int16_t celsius = getTemperature();
+  if (celsius == temperature_unknown) return false; // safe
+  return (celsius >= _fast_full_min_temperature) && (celsius <= _fast_full_max_temperature);
+}
+
+uint32_t GxEPD2_4G_EPD::calibrateSPI(uint32_t max_frequency, uint8_t margin_steps)
+{
+  static const uint32_t frequencies[] = {4000000, 8000000, 10000000, 13333333, 16000000, 20000000, 26666666, 40000000};
+  static const int16_t w = 128, h = 2; // test area
+  static const uint16_t n = w / 8 * h;
+  uint8_t saved1[n], saved2[n], pattern1[n], pattern2[n];
+  if (!_init_4G_done || _initial_write) return 0; // writeNativePart_4G() would init grey mode and clear controller memory
+  if (!readNativePart_4G(saved1, saved2, 0, 0, w, h)) return 0;
+  SPISettings original = _spi_settings;
+  int8_t passed = -1;
+  for (uint8_t i = 0; i < sizeof(frequencies) / sizeof(frequencies[0]); i++)
+  {
+    if (frequencies[i] > max_frequency) break;
+    _spi_settings = SPISettings(frequencies[i], MSBFIRST, SPI_MODE0);
+    for (uint16_t j = 0; j < n; j++) // edges and changing bytes
+    {
+      pattern1[j] = (j & 1) ? 0x55 ^ (j + i) : 0xAA;
+      pattern2[j] = (j & 1) ? 0xFF - j * 7 : 0x0F ^ (i << 4);
+    }
+    writeNativePart_4G(pattern1, pattern2, 0, 0, w, h, 0, 0, w, h);
+    if (!verifyNativePart_4G(pattern1, pattern2, 0, 0, w, h)) break;
+    passed = i;
+  }
+  if (passed >= 0)
+  {
+    passed = passed > margin_steps ? passed - margin_steps : 0; // at least the lowest passing clock
+    _spi_settings = SPISettings(frequencies[passed], MSBFIRST, SPI_MODE0);
+    writeNativePart_4G(saved1, saved2, 0, 0, w, h, 0, 0, w, h);
+    if (verifyNativePart_4G(saved1, saved2, 0, 0, w, h)) return frequencies[passed];
+  }
+  _spi_settings = original; // no clock passed, or the restore failed at the selected clock
+  writeNativePart_4G(saved1, saved2, 0, 0, w, h, 0, 0, w, h);
+  return 0;
+}
+
+bool GxEPD2_4G_EPD::verifyNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  uint8_t line1[16], line2[16]; // chunks of 128 pixels
+  int16_t wb = (w + 7) / 8;
+  for (int16_t i = 0; i < h; i++)
+  {
+    for (int16_t j = 0; j < wb; j += sizeof(line1))
+    {
+      int16_t n = wb - j < int16_t(sizeof(line1)) ? wb - j : sizeof(line1);
+      if (!readNativePart_4G(line1, line2, x + 8 * j, y + i, 8 * n, 1)) return false;
+      if (memcmp(line1, plane1 + i * wb + j, n) || memcmp(line2, plane2 + i * wb + j, n)) return false;
+    }
+  }
+  return true;
+}
+
+void GxEPD2_4G_EPD::setTrace(GxEPD2_4G_Trace* trace)
+{
+  if (_trace) _trace->flush();
+  _trace = trace;
+  if (_trace) _trace->begin(panel, WIDTH, HEIGHT);
+}
+
 void GxEPD2_4G_EPD::_reset()
 {
+  if (_busy_wait_pending) finishBusyWait();
   if (_rst >= 0)
   {
+    if (_trace) _trace->reset();
+    _invalidateLuts();
     if (_pulldown_rst_mode)
     {
       digitalWrite(_rst, LOW);
@@ -134,46 +391,215 @@ void GxEPD2_4G_EPD::_reset()
   }
 }
 
+void GxEPD2_4G_EPD::setDeferredBusyWait(bool deferred)
+{
+  _busy_wait_deferred = deferred;
+  if (!deferred) finishBusyWait();
+}
+
+bool GxEPD2_4G_EPD::isBusy()
+{
+  if (!_busy_wait_pending) return false;
+  if (_busy >= 0) return (digitalRead(_busy) == _busy_level) && (micros() - _busy_start <= _busy_timeout);
+  return (micros() - _busy_start) / 1000 < _busy_time; // no BUSY pin : expected refresh time
+}
+
 void GxEPD2_4G_EPD::_waitWhileBusy(const char* comment, uint16_t busy_time)
 {
+  if (_busy_wait_pending) finishBusyWait();
+  if (_busy >= 0) delay(1); // add some margin to become active
+  _busy_start = micros();
+  _busy_comment = comment;
+  _busy_time = busy_time;
+  _busy_wait_pending = true;
+  if (!_busy_wait_deferred) finishBusyWait();
+}
+
+void GxEPD2_4G_EPD::finishBusyWait()
+{
+  if (!_busy_wait_pending) return;
+  _busy_wait_pending = false;
+  unsigned long start = _busy_start;
   if (_busy >= 0)
   {
-    delay(1); // add some margin to become active
-    unsigned long start = micros();
+    BusyTiming* timing = _adaptive_busy_wait ? _busyTiming(_busy_comment, _busy_time) : 0;
+    bool slept = false, seen_busy = false, timeout = false;
+    if (timing && (timing->count > 0) && (timing->time_us >= 20000))
+    {
+      uint32_t sleep = timing->time_us - timing->time_us / 64; // poll the last 1.5%
+      slept = (micros() - start + 1000 <= sleep);
+      while (micros() - start + 1000 <= sleep)
+      {
+        if (_busy_callback) _busy_callback(_busy_callback_parameter);
+        else delay((sleep - (micros() - start)) / 1000);
+      }
+    }
     while (1)
     {
+      _busy_polls++;
       if (digitalRead(_busy) != _busy_level) break;
+      seen_busy = true;
       if (_busy_callback) _busy_callback(_busy_callback_parameter);
       else delay(1);
+      _busy_polls++;
       if (digitalRead(_busy) != _busy_level) break;
       if (micros() - start > _busy_timeout)
       {
         Serial.println("Busy Timeout!");
+        timeout = true;
         break;
       }
 #if defined(ESP8266) || defined(ESP32)
       yield(); // avoid wdt
 #endif
     }
-    if (comment)
+    if (timing && !timeout)
+    {
+      if (seen_busy) timing->time_us = timing->count ? timing->time_us / 2 + (micros() - start) / 2 : micros() - start;
+      else if (slept) timing->time_us -= timing->time_us / 4; // ended during sleep, shorten
+      if (seen_busy || slept) timing->count++;
+    }
+    if (_busy_comment)
     {
 #if !defined(DISABLE_DIAGNOSTIC_OUTPUT)
       if (_diag_enabled)
       {
         unsigned long elapsed = micros() - start;
-        Serial.print(comment);
+        Serial.print(_busy_comment);
         Serial.print(" : ");
         Serial.println(elapsed);
       }
 #endif
     }
-    (void) start;
+    if (_trace) _trace->busy(micros() - start);
+    if (_energy_figures) _energyBusy(_busy_comment, start, micros() - start);
+  }
+  else
+  {
+    uint32_t elapsed = (micros() - start) / 1000;
+    if (elapsed < _busy_time) delay(_busy_time - elapsed);
+    if (_trace) _trace->busy(uint32_t(_busy_time) * 1000);
+    if (_energy_figures) _energyBusy(_busy_comment, start, uint32_t(_busy_time) * 1000);
   }
-  else delay(busy_time);
+}
+
+void GxEPD2_4G_EPD::setAdaptiveBusyWait(bool enabled)
+{
+  _adaptive_busy_wait = enabled;
+}
+
+const GxEPD2_4G_EPD::BusyTiming* GxEPD2_4G_EPD::busyTiming(uint8_t index)
+{
+  return index < _busy_timing_count ? &_busy_timings[index] : 0;
+}
+
+uint32_t GxEPD2_4G_EPD::busyTime(const char* phase)
+{
+  for (uint8_t i = 0; i < _busy_timing_count; i++)
+  {
+    if ((_busy_timings[i].count > 0) && (strcmp(_busy_timings[i].phase, phase) == 0)) return _busy_timings[i].time_us;
+  }
+  return 0;
+}
+
+GxEPD2_4G_EPD::BusyTiming* GxEPD2_4G_EPD::_busyTiming(const char* phase, uint16_t busy_time)
+{
+  if (!phase) return 0;
+  for (uint8_t i = 0; i < _busy_timing_count; i++)
+  {
+    BusyTiming& timing = _busy_timings[i];
+    if ((timing.busy_time == busy_time) && ((timing.phase == phase) || (strcmp(timing.phase, phase) == 0))) return &timing;
+  }
+  if (_busy_timing_count >= busy_timings_size) return 0;
+  BusyTiming& timing = _busy_timings[_busy_timing_count++];
+  timing.phase = phase;
+  timing.busy_time = busy_time;
+  timing.count = 0;
+  timing.time_us = 0;
+  return &timing;
+}
+
+void GxEPD2_4G_EPD::setEnergyFigures(const EnergyFigures* figures)
+{
+  if (figures && !_energy_figures) _energy_last = micros();
+  _energy_figures = figures;
+}
+
+void GxEPD2_4G_EPD::resetEnergy()
+{
+  memset(&_energy_refresh, 0, sizeof(_energy_refresh));
+  memset(&_energy_total, 0, sizeof(_energy_total));
+  for (uint8_t i = 0; i < energy_phases; i++) _energy_busy_us[i] = 0;
+  _energy_power_on_us = 0;
+  _energy_spi_us = 0;
+  _energy_spi_bytes = 0;
+  _energy_last = micros();
+  _energy_spi_start = 0;
+}
+
+GxEPD2_4G_EPD::EnergyPhase GxEPD2_4G_EPD::_energyPhase(const char* comment)
+{
+  if (!comment) return energy_other;
+  if (strncmp(comment, "_PowerOn", 8) == 0) return energy_power_on;
+  if (strncmp(comment, "_PowerOff", 9) == 0) return energy_power_off;
+  if (strncmp(comment, "_Update_Full", 12) == 0) return energy_full;
+  if ((strncmp(comment, "_Update_4G", 10) == 0) || (strcmp(comment, "refresh 4G") == 0)) return energy_grey;
+  if ((strncmp(comment, "_Update_Part", 12) == 0) || (strcmp(comment, "refresh") == 0)) return energy_partial;
+  return energy_other;
+}
+
+void GxEPD2_4G_EPD::_energyTick(unsigned long now)
+{
+  if (_power_is_on && (long(now - _energy_last) > 0)) _energy_power_on_us += now - _energy_last;
+  _energy_last = now;
+}
+
+void GxEPD2_4G_EPD::_energyBusy(const char* comment, unsigned long start, uint32_t busy_us)
+{
+  _energyTick(start);
+  EnergyPhase phase = _energyPhase(comment);
+  _energy_busy_us[phase] += busy_us;
+  _energy_last = micros();
+  if ((phase != energy_full) && (phase != energy_grey) && (phase != energy_partial)) return;
+  // close the refresh record
+  uint64_t charge = uint64_t(_energy_power_on_us) * _energy_figures->power_on_current + uint64_t(_energy_spi_us) * _energy_figures->spi_current;
+  _energy_refresh.refreshes = 1;
+  for (uint8_t i = 0; i < energy_phases; i++)
+  {
+    charge += uint64_t(_energy_busy_us[i]) * _energy_figures->busy_current[i];
+    _energy_refresh.busy_ms[i] = _energy_busy_us[i] / 1000;
+    _energy_total.busy_ms[i] += _energy_refresh.busy_ms[i];
+    _energy_busy_us[i] = 0;
+  }
+  _energy_refresh.power_on_ms = _energy_power_on_us / 1000;
+  _energy_refresh.spi_ms = _energy_spi_us / 1000;
+  _energy_refresh.spi_bytes = _energy_spi_bytes;
+  _energy_refresh.charge_nAh = charge / 3600000ul; // uA * us = pC, 1 nAh = 3.6 uC
+  _energy_total.refreshes++;
+  _energy_total.power_on_ms += _energy_refresh.power_on_ms;
+  _energy_total.spi_ms += _energy_refresh.spi_ms;
+  _energy_total.spi_bytes += _energy_spi_bytes;
+  _energy_total.charge_nAh += _energy_refresh.charge_nAh;
+  _energy_power_on_us = 0;
+  _energy_spi_us = 0;
+  _energy_spi_bytes = 0;
+}
+
+void GxEPD2_4G_EPD::_energySPI(uint16_t bytes)
+{
+  _energy_spi_us += micros() - _energy_spi_start;
+  _energy_spi_bytes += bytes;
 }
 
 void GxEPD2_4G_EPD::_writeCommand(uint8_t c)
 {
+  if (_busy_wait_pending) finishBusyWait(); // don't disturb a running refresh
+  if (_energy_figures)
+  {
+    _energy_spi_start = micros();
+    _energyTick(_energy_spi_start); // power state changes with commands
+  }
+  if (_trace) _trace->command(c);
   _pSPIx->beginTransaction(_spi_settings);
   if (_dc >= 0) digitalWrite(_dc, LOW);
   if (_cs >= 0) digitalWrite(_cs, LOW);
@@ -181,19 +607,27 @@ void GxEPD2_4G_EPD::_writeCommand(uint8_t c)
   if (_cs >= 0) digitalWrite(_cs, HIGH);
   if (_dc >= 0) digitalWrite(_dc, HIGH);
   _pSPIx->endTransaction();
+  if (_energy_figures) _energySPI(1);
 }
 
 void GxEPD2_4G_EPD::_writeData(uint8_t d)
 {
+  if (_busy_wait_pending) finishBusyWait();
+  if (_energy_figures) _energy_spi_start = micros();
+  if (_trace) _trace->data(d);
   _pSPIx->beginTransaction(_spi_settings);
   if (_cs >= 0) digitalWrite(_cs, LOW);
   _pSPIx->transfer(d);
   if (_cs >= 0) digitalWrite(_cs, HIGH);
   _pSPIx->endTransaction();
+  if (_energy_figures) _energySPI(1);
 }
 
 void GxEPD2_4G_EPD::_writeData(const uint8_t* data, uint16_t n)
 {
+  if (_busy_wait_pending) finishBusyWait();
+  if (_energy_figures) _energy_spi_start = micros();
+  if (_trace) _trace->data(data, n);
   _pSPIx->beginTransaction(_spi_settings);
   if (_cs >= 0) digitalWrite(_cs, LOW);
   for (uint16_t i = 0; i < n; i++)
@@ -202,46 +636,116 @@ void GxEPD2_4G_EPD::_writeData(const uint8_t* data, uint16_t n)
   }
   if (_cs >= 0) digitalWrite(_cs, HIGH);
   _pSPIx->endTransaction();
+  if (_energy_figures) _energySPI(n);
+}
+
+void GxEPD2_4G_EPD::_readData(uint8_t* data, uint16_t n, uint8_t dummy)
+{
+  if (_busy_wait_pending) finishBusyWait();
+  if (_energy_figures) _energy_spi_start = micros();
+#if !defined(ESP32) // on ESP32 pinMode() detaches the pins from the SPI bus
+  _pSPIx->end(); // release SDA and SCK
+#endif
+  pinMode(_sda, INPUT);
+  digitalWrite(_sck, LOW);
+  pinMode(_sck, OUTPUT);
+  if (_cs >= 0) digitalWrite(_cs, LOW);
+  for (uint16_t i = 0; i < n + dummy; i++)
+  {
+    uint8_t value = 0;
+    for (uint8_t b = 0; b < 8; b++) // MSB first, controller shifts out on falling edge
+    {
+      digitalWrite(_sck, HIGH);
+      value = (value << 1) | (digitalRead(_sda) ? 1 : 0);
+      digitalWrite(_sck, LOW);
+    }
+    if (i >= dummy) *data++ = value;
+  }
+  if (_cs >= 0) digitalWrite(_cs, HIGH);
+#if defined(ESP32)
+  spiAttachSCK(_pSPIx->bus(), _sck); // keeps custom pins of the SPI instance
+  spiAttachMOSI(_pSPIx->bus(), _sda);
+#else
+  _pSPIx->begin(); // default pins, see _canRead()
+#endif
+  if (_energy_figures) _energySPI(n + dummy);
 }
 
 void GxEPD2_4G_EPD::_writeDataPGM(const uint8_t* data, uint16_t n, int16_t fill_with_zeroes)
 {
+  if (_busy_wait_pending) finishBusyWait();
+  if (_energy_figures) _energy_spi_start = micros();
+  uint16_t bytes = n + (fill_with_zeroes > 0 ? fill_with_zeroes : 0);
   _pSPIx->beginTransaction(_spi_settings);
   if (_cs >= 0) digitalWrite(_cs, LOW);
   for (uint16_t i = 0; i < n; i++)
   {
-    _pSPIx->transfer(pgm_read_byte(&*data++));
+    uint8_t d = pgm_read_byte(&*data++);
+    if (_trace) _trace->data(d);
+    _pSPIx->transfer(d);
   }
   while (fill_with_zeroes > 0)
   {
+    if (_trace) _trace->data(0x00);
     _pSPIx->transfer(0x00);
     fill_with_zeroes--;
   }
   if (_cs >= 0) digitalWrite(_cs, HIGH);
   _pSPIx->endTransaction();
+  if (_energy_figures) _energySPI(bytes);
 }
 
 void GxEPD2_4G_EPD::_writeDataPGM_sCS(const uint8_t* data, uint16_t n, int16_t fill_with_zeroes)
 {
+  if (_busy_wait_pending) finishBusyWait();
+  if (_energy_figures) _energy_spi_start = micros();
+  uint16_t bytes = n + (fill_with_zeroes > 0 ? fill_with_zeroes : 0);
   _pSPIx->beginTransaction(_spi_settings);
   for (uint8_t i = 0; i < n; i++)
   {
+    uint8_t d = pgm_read_byte(&*data++);
+    if (_trace) _trace->dataSCS(d);
     if (_cs >= 0) digitalWrite(_cs, LOW);
-    _pSPIx->transfer(pgm_read_byte(&*data++));
+    _pSPIx->transfer(d);
     if (_cs >= 0) digitalWrite(_cs, HIGH);
   }
   while (fill_with_zeroes > 0)
   {
+    if (_trace) _trace->dataSCS(0x00);
     if (_cs >= 0) digitalWrite(_cs, LOW);
     _pSPIx->transfer(0x00);
     fill_with_zeroes--;
     if (_cs >= 0) digitalWrite(_cs, HIGH);
   }
   _pSPIx->endTransaction();
+  if (_energy_figures) _energySPI(bytes);
+}
+
+void GxEPD2_4G_EPD::_writeData_sCS(const uint8_t* data, uint16_t n)
+{
+  if (_busy_wait_pending) finishBusyWait();
+  if (_energy_figures) _energy_spi_start = micros();
+  _pSPIx->beginTransaction(_spi_settings);
+  for (uint16_t i = 0; i < n; i++)
+  {
+    if (_trace) _trace->dataSCS(data[i]);
+    if (_cs >= 0) digitalWrite(_cs, LOW);
+    _pSPIx->transfer(data[i]);
+    if (_cs >= 0) digitalWrite(_cs, HIGH);
+  }
+  _pSPIx->endTransaction();
+  if (_energy_figures) _energySPI(n);
 }
 
 void GxEPD2_4G_EPD::_writeCommandData(const uint8_t* pCommandData, uint8_t datalen)
 {
+  if (_busy_wait_pending) finishBusyWait();
+  if (_energy_figures) _energy_spi_start = micros();
+  if (_trace)
+  {
+    _trace->command(pCommandData[0]);
+    _trace->data(pCommandData + 1, datalen - 1);
+  }
   _pSPIx->beginTransaction(_spi_settings);
   if (_dc >= 0) digitalWrite(_dc, LOW);
   if (_cs >= 0) digitalWrite(_cs, LOW);
@@ -253,10 +757,18 @@ void GxEPD2_4G_EPD::_writeCommandData(const uint8_t* pCommandData, uint8_t datal
   }
   if (_cs >= 0) digitalWrite(_cs, HIGH);
   _pSPIx->endTransaction();
+  if (_energy_figures) _energySPI(datalen);
 }
 
 void GxEPD2_4G_EPD::_writeCommandDataPGM(const uint8_t* pCommandData, uint8_t datalen)
 {
+  if (_busy_wait_pending) finishBusyWait();
+  if (_energy_figures) _energy_spi_start = micros();
+  if (_trace)
+  {
+    _trace->command(pgm_read_byte(&pCommandData[0]));
+    for (uint8_t i = 1; i < datalen; i++) _trace->data(pgm_read_byte(&pCommandData[i]));
+  }
   _pSPIx->beginTransaction(_spi_settings);
   if (_dc >= 0) digitalWrite(_dc, LOW);
   if (_cs >= 0) digitalWrite(_cs, LOW);
@@ -268,21 +780,92 @@ void GxEPD2_4G_EPD::_writeCommandDataPGM(const uint8_t* pCommandData, uint8_t da
   }
   if (_cs >= 0) digitalWrite(_cs, HIGH);
   _pSPIx->endTransaction();
+  if (_energy_figures) _energySPI(datalen);
+}
+
+void GxEPD2_4G_EPD::_writeLutPGM(uint8_t command, const uint8_t* data, uint16_t n, int16_t fill_with_zeroes)
+{
+  if (_lutLoaded(command, data)) return;
+  _writeCommand(command);
+  _writeDataPGM(data, n, fill_with_zeroes);
+}
+
+void GxEPD2_4G_EPD::_writeLutPGM_sCS(uint8_t command, const uint8_t* data, uint16_t n, int16_t fill_with_zeroes)
+{
+  if (_lutLoaded(command, data)) return;
+  _writeCommand(command);
+  _writeDataPGM_sCS(data, n, fill_with_zeroes);
+}
+
+bool GxEPD2_4G_EPD::_lutLoaded(uint8_t command, const uint8_t* data)
+{
+  uint8_t slot = lut_cache_size;
+  for (uint8_t i = 0; i < lut_cache_size; i++)
+  {
+    if (_lut_loaded[i] && (_lut_command[i] == command))
+    {
+      if (_lut_loaded[i] == data)
+      {
+        _lut_uploads_skipped++;
+        return true;
+      }
+      slot = i;
+      break;
+    }
+    if (!_lut_loaded[i] && (slot == lut_cache_size)) slot = i;
+  }
+  // not loaded, remember as loaded by the upload that follows
+  if (slot < lut_cache_size)
+  {
+    _lut_command[slot] = command;
+    _lut_loaded[slot] = data;
+  }
+  _lut_uploads++;
+  return false;
+}
+
+void GxEPD2_4G_EPD::_writeLutSet(const LutSet& lut_set)
+{
+  for (uint8_t i = 0; i < lut_set.count; i++)
+  {
+    const LutTable& t = lut_set.tables[i];
+    _writeLutPGM(t.command, t.data, t.size, t.padded_size > t.size ? t.padded_size - t.size : 0);
+  }
+}
+
+uint16_t GxEPD2_4G_EPD::_lutRefreshTime(LutMode mode, uint16_t built_in_time)
+{
+  uint16_t refresh_time = lutRefreshTime(mode);
+  return refresh_time > 0 ? refresh_time : built_in_time;
+}
+
+void GxEPD2_4G_EPD::_invalidateLuts()
+{
+  for (uint8_t i = 0; i < lut_cache_size; i++)
+  {
+    _lut_command[i] = 0;
+    _lut_loaded[i] = 0;
+  }
 }
 
 void GxEPD2_4G_EPD::_startTransfer()
 {
+  if (_busy_wait_pending) finishBusyWait();
+  if (_energy_figures) _energy_spi_start = micros();
   _pSPIx->beginTransaction(_spi_settings);
   if (_cs >= 0) digitalWrite(_cs, LOW);
 }
 
 void GxEPD2_4G_EPD::_transfer(uint8_t value)
 {
+  if (_trace) _trace->data(value);
   _pSPIx->transfer(value);
+  if (_energy_figures) _energy_spi_bytes++;
 }
 
 void GxEPD2_4G_EPD::_endTransfer()
 {
   if (_cs >= 0) digitalWrite(_cs, HIGH);
   _pSPIx->endTransaction();
+  if (_energy_figures) _energySPI(0);
 }
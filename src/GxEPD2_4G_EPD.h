@@ -16,6 +16,7 @@
 #include <SPI.h>
 
 #include <GxEPD2_4G.h>
+#include "GxEPD2_4G_Trace.h"
 
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 //#pragma GCC diagnostic ignored "-Wsign-compare"
@@ -30,11 +31,54 @@ class GxEPD2_4G_EPD
     const bool hasColor;
     const bool hasPartialUpdate;
     const bool hasFastPartialUpdate;
+    // grey partial refresh is limited to the window, else drives full screen
+    // false for SSD16xx: no display update limited to an area, the RAM window only limits writing, every update
+    // drives all pixels with the loaded grey LUT; UC81xx (partial in 0x91) and EK79652 (0x16) drive the window only
+    const bool hasPartialUpdateWindow_4G;
+    // LUT table for one controller LUT register (UC81xx 0x20..0x25, SSD16xx 0x32), data in PROGMEM
+    struct LutTable
+    {
+      uint8_t command;
+      const uint8_t* data;
+      uint16_t size;
+      uint16_t padded_size; // filled with zeroes up to padded_size, if larger than size
+    };
+    // set of LUT tables for one refresh mode, tables array in RAM
+    struct LutSet
+    {
+      const LutTable* tables;
+      uint8_t count;
+      uint16_t refresh_time; // ms, expected refresh time with this set, 0 : as built-in tables
+    };
+    enum LutMode {lut_full, lut_grey, lut_partial, lut_grey_fast}; // lut_grey_fast : short grey waveform, see setFastGreyRefresh()
+    static const uint8_t lut_cache_size = 6;
+    // library state kept across processor deep sleep, e.g. in RTC memory or flash, see saveState() and init(bitrate, state)
+    // LUT cache entries are table addresses, the state is valid for the same firmware only; no padding on common targets
+    struct State
+    {
+      const uint8_t* lut_loaded[lut_cache_size];
+      uint16_t check; // of all other bytes
+      uint16_t width, height, reset_duration;
+      int16_t temperature;
+      uint8_t version, panel, flags, driver_state, fast_grey_count;
+      uint8_t rotation, gfx_flags; // of the GFX classes
+      uint8_t reserved;
+      uint8_t lut_command[lut_cache_size];
+      enum {initial_write = 0x01, initial_refresh = 0x02, power_is_on = 0x04, using_partial_mode = 0x08,
+            hibernating = 0x10, init_display_done = 0x20, init_4G_done = 0x40, pulldown_rst_mode = 0x80};
+      static const uint8_t current_version = 1;
+    };
     // constructor
     GxEPD2_4G_EPD(int16_t cs, int16_t dc, int16_t rst, int16_t busy, int16_t busy_level, uint32_t busy_timeout,
-               uint16_t w, uint16_t h, GxEPD2_4G::Panel p, bool c, bool pu, bool fpu);
+               uint16_t w, uint16_t h, GxEPD2_4G::Panel p, bool c, bool pu, bool fpu, bool pw4g = false);
     virtual void init(uint32_t serial_diag_bitrate = 0); // serial_diag_bitrate = 0 : disabled
     virtual void init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset_duration = 10, bool pulldown_rst_mode = false);
+    // init after processor deep sleep with the state saved before, without reset of the controller: the next update
+    // continues in the refresh mode, with the LUTs and controller memory of before; controller power and RST level must
+    // have been kept during sleep; returns false and does init(serial_diag_bitrate) if the state is not valid for this panel
+    bool init(uint32_t serial_diag_bitrate, const State& state);
+    // e.g. before processor deep sleep, after powerOff() or hibernate(); rotation and gfx_flags of the GFX classes
+    void saveState(State& state, uint8_t rotation = 0, uint8_t gfx_flags = 0);
     virtual void end(); // release SPI and control pins
     //  Support for Bitmaps (Sprites) to Controller Buffer and to Screen
     virtual void clearScreen(uint8_t value) = 0; // init controller memory and screen (default white)
@@ -51,6 +95,20 @@ class GxEPD2_4G_EPD
                                 int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) = 0;
     virtual void writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                                    int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) = 0;
+    // write two 1bpp planes to controller memory, native format of 4 grey level write, without screen refresh
+    // plane1 : high bit of grey level, set for white and light grey; plane2 : low bit, set for white and dark grey
+    // this polarity is the same for all controllers: SSD16xx drivers invert the planes to controller memory, as writeImage_4G() does
+    // planes in RAM, rows padded to whole bytes; x and w should be multiple of 8
+    virtual void writeNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                    int16_t x, int16_t y, int16_t w, int16_t h) = 0;
+    // read two 1bpp planes back from controller memory, same format and polarity as writeNativePart_4G, rows of w / 8 bytes
+    // x and w must be multiple of 8; returns false if the controller can't be read, or read pins are not set
+    virtual bool readNativePart_4G(uint8_t* plane1, uint8_t* plane2, int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      return false;
+    };
+    // reads back and compares a native write, line by line; returns false on mismatch or if not readable
+    bool verifyNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x, int16_t y, int16_t w, int16_t h);
     virtual void writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) = 0;
     virtual void writeImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                                 int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) = 0;
@@ -85,7 +143,34 @@ class GxEPD2_4G_EPD
     virtual void refresh(int16_t x, int16_t y, int16_t w, int16_t h) = 0; // screen refresh from controller memory, partial screen
     virtual void powerOff() = 0; // turns off generation of panel driving voltages, avoids screen fading over time
     virtual void hibernate() = 0; // turns powerOff() and sets controller to deep sleep for minimum power use, ONLY if wakeable by RST (rst >= 0)
+    bool isPowerOn() // panel driving voltages on, e.g. kept on after refresh by a power policy
+    {
+      return _power_is_on;
+    };
     virtual void setPaged() {}; // for GxEPD2_154c paged workaround
+    // register an alternative LUT set for a refresh mode, 0 restores the built-in tables
+    // takes effect on next init of that refresh mode; returns false if the driver doesn't support it
+    virtual bool setLutSet(LutMode mode, const LutSet* lut_set)
+    {
+      return false;
+    };
+    // waveform registry: validated LUT sets for the refresh modes, selected at runtime, e.g. by expected refresh time
+    static const uint8_t lut_registry_size = 8;
+    int8_t registerLutSet(LutMode mode, const LutSet* lut_set); // returns index, or -1 if registry full
+    bool selectLutSet(uint8_t index); // setLutSet() of a registered set
+    // selects the slowest registered set of mode within max_refresh_time, slower sets are assumed better quality
+    // returns index, or -1 if none fits (selection unchanged)
+    int8_t selectLutSet(LutMode mode, uint16_t max_refresh_time);
+    uint16_t lutRefreshTime(LutMode mode); // expected refresh time of the selected set, 0 if built-in tables
+    // LUT uploads done and skipped because the same table was still loaded in the controller
+    uint32_t lutUploads()
+    {
+      return _lut_uploads;
+    };
+    uint32_t lutUploadsSkipped()
+    {
+      return _lut_uploads_skipped;
+    };
     // register a callback function to be called during _waitWhileBusy continuously.
     void setBusyCallback(void (*busyCallback)(const void*), const void* busy_callback_parameter = 0);
     static inline uint16_t gx_uint16_min(uint16_t a, uint16_t b)
@@ -97,6 +182,90 @@ class GxEPD2_4G_EPD
       return (a > b ? a : b);
     };
     void selectSPI(SPIClass& spi, SPISettings spi_settings);
+    // panel temperature in degree Celsius, cached; read from the controller sensor at most once per interval_ms,
+    // if the driver supports it (SSD16xx with setReadPins()); interval_ms = 0 : no sensor reads (default)
+    static const int16_t temperature_unknown = -1000;
+    void setTemperatureInterval(uint32_t interval_ms);
+    void setTemperature(int16_t celsius); // e.g. from a sensor on the board, valid until the next sensor read
+    int16_t getTemperature(); // temperature_unknown if not set and not read
+    // full refresh uses the fast waveform while the temperature is within range, else the temperature compensated one
+    // for drivers with useFastFullUpdate; default (min > max) : compile time useFastFullUpdate
+    void setFastFullUpdateRange(int16_t min_celsius, int16_t max_celsius);
+    // grey partial refresh, refresh(x, y, w, h) in grey mode, uses the short lut_grey_fast waveform without the clearing
+    // phases, for up to max_count refreshes after a full grey refresh (ghosting budget); windows larger than half the
+    // screen use the full grey waveform; max_count = 0 : disabled (default); for drivers with a lut_grey_fast waveform
+    // no clearing phase: changed pixels start from an arbitrary level, so their new grey level is approximate, and
+    // unchanged pixels drift; the next full grey refresh restores all levels
+    void setFastGreyRefresh(uint8_t max_count);
+    // SSD16xx controllers output read data on the bidirectional SDA line, read by bit banging the SPI pins
+    // sda : the MOSI pin connected to SDA (DIN), sck : the SCK pin; -1 disables reads (default)
+    // ESP32 : the pins are re-attached to the SPI bus after a read, custom SPI pins (e.g. hspi.begin(sck, miso, mosi, ss)) work
+    // other processors : the pins are given back by end() and begin() of the SPI instance, which restore only the default
+    // pins; reads are refused unless the SPI instance is SPI with its default pins MOSI and SCK
+    void setReadPins(int16_t sda, int16_t sck);
+    // steps the SPI clock up while a test pattern written to controller memory reads back correctly, needs readback
+    // keeps the highest passing clock less margin_steps steps, at least the lowest passing clock; the test area
+    // (0, 0, 128, 2) is restored and verified at the selected clock, else restored at the original clock
+    // needs grey mode with controller memory written, e.g. after a grey update; nothing is written otherwise
+    // a failing clock may also corrupt the RAM window or address commands, then other content may be lost
+    // returns the frequency selected, or 0 if not in grey mode, the controller can't be read, no clock passed
+    // or the restore failed (SPI settings unchanged)
+    uint32_t calibrateSPI(uint32_t max_frequency = 40000000, uint8_t margin_steps = 1);
+    // deferred busy wait: refresh() returns after starting the refresh, the wait for BUSY is done by finishBusyWait(),
+    // or by the next command or data sent to this panel; e.g. to overlap the refresh of several panels
+    void setDeferredBusyWait(bool deferred); // false : finishes a pending wait
+    bool isBusy(); // true while a deferred wait is pending and the panel is still busy
+    void finishBusyWait(); // waits for the end of a pending deferred wait, if any
+    // adaptive busy wait: learns the BUSY time of each phase (wait with the same comment and driver time), then sleeps by
+    // delay() for 63/64 of the learned time before polling BUSY; a busy callback is called instead of delay()
+    // the first wait of a phase polls, and phases shorter than 20ms always poll; for panels with BUSY pin
+    struct BusyTiming
+    {
+      const char* phase; // e.g. "_Update_Full", see diagnostic output
+      uint16_t busy_time; // ms, driver time of the wait, e.g. of the LUT set selected
+      uint16_t count; // waits measured
+      uint32_t time_us; // learned BUSY time, running average
+    };
+    static const uint8_t busy_timings_size = 8;
+    void setAdaptiveBusyWait(bool enabled); // default false
+    const BusyTiming* busyTiming(uint8_t index); // learned timings, 0 if index beyond
+    uint32_t busyTime(const char* phase); // learned BUSY time of phase in us, first match, 0 if not learned
+    uint32_t busyPolls() // BUSY pin reads, e.g. to compare wakeups
+    {
+      return _busy_polls;
+    };
+    // energy accounting: charge estimate of each refresh, from measured BUSY times per phase, time with driving voltages
+    // on outside BUSY, SPI bytes and transfer time, and the current figures of the application
+    // a refresh record is closed at the end of the BUSY of a full, grey or partial refresh, it contains all since the
+    // previous one, e.g. writes, power on and refresh; power off after a refresh goes to the next record
+    enum EnergyPhase {energy_power_on, energy_full, energy_grey, energy_partial, energy_power_off, energy_other, energy_phases};
+    struct EnergyFigures // currents in uA, e.g. measured on the board
+    {
+      uint32_t busy_current[energy_phases]; // panel and processor during BUSY of the phase
+      uint32_t power_on_current; // panel with driving voltages on, outside BUSY
+      uint32_t spi_current; // processor and panel during transfers
+    };
+    struct EnergyRecord
+    {
+      uint32_t refreshes;
+      uint32_t busy_ms[energy_phases];
+      uint32_t power_on_ms; // driving voltages on, outside BUSY
+      uint32_t spi_ms;
+      uint32_t spi_bytes;
+      uint32_t charge_nAh; // estimate from the figures, nAh (uAs / 3.6)
+    };
+    void setEnergyFigures(const EnergyFigures* figures); // starts accounting, 0 stops (default); figures must stay valid
+    const EnergyRecord& lastRefreshEnergy() // last closed refresh record
+    {
+      return _energy_refresh;
+    };
+    const EnergyRecord& totalEnergy() // sum of closed refresh records
+    {
+      return _energy_total;
+    };
+    void resetEnergy();
+    // record all commands, data and busy waits to a trace log; 0 to stop recording
+    void setTrace(GxEPD2_4G_Trace* trace);
   protected:
     void _reset();
     void _waitWhileBusy(const char* comment = 0, uint16_t busy_time = 5000);
@@ -105,13 +274,43 @@ class GxEPD2_4G_EPD
     void _writeData(const uint8_t* data, uint16_t n);
     void _writeDataPGM(const uint8_t* data, uint16_t n, int16_t fill_with_zeroes = 0);
     void _writeDataPGM_sCS(const uint8_t* data, uint16_t n, int16_t fill_with_zeroes = 0);
+    void _writeData_sCS(const uint8_t* data, uint16_t n); // each byte in its own chip select, from RAM
     void _writeCommandData(const uint8_t* pCommandData, uint8_t datalen);
+    // reads n bytes after dummy bytes in one chip select, SPI released during the read; not recorded by trace
+    void _readData(uint8_t* data, uint16_t n, uint8_t dummy = 0);
+    void _initPins(uint32_t serial_diag_bitrate, bool reset);
+    uint16_t _stateCheck(const State& state);
+    BusyTiming* _busyTiming(const char* phase, uint16_t busy_time); // found or added, 0 if no phase or table full
+    EnergyPhase _energyPhase(const char* comment); // of a busy wait
+    void _energyTick(unsigned long now); // accounts time with driving voltages on up to now
+    void _energyBusy(const char* comment, unsigned long start, uint32_t busy_us);
+    void _energySPI(uint16_t bytes); // transfer started at _energy_spi_start
+    virtual uint8_t _saveDriverState() // e.g. refresh mode
+    {
+      return 0;
+    };
+    virtual void _restoreDriverState(uint8_t state) {};
+    virtual bool _readTemperature(int16_t& celsius) // controller temperature sensor, if supported
+    {
+      return false;
+    };
+    bool _useFastFullUpdate(bool compiled); // evaluates setFastFullUpdateRange() for the temperature
+    bool _useFastGrey(uint16_t w, uint16_t h); // true and counted if within the budget of setFastGreyRefresh()
+    bool _canRead();
     void _writeCommandDataPGM(const uint8_t* pCommandData, uint8_t datalen);
+    // LUT upload to LUT register command, skipped if the same table is still loaded
+    void _writeLutPGM(uint8_t command, const uint8_t* data, uint16_t n, int16_t fill_with_zeroes = 0);
+    void _writeLutPGM_sCS(uint8_t command, const uint8_t* data, uint16_t n, int16_t fill_with_zeroes = 0);
+    void _writeLutSet(const LutSet& lut_set);
+    uint16_t _lutRefreshTime(LutMode mode, uint16_t built_in_time); // busy time for the selected set of mode
+    void _invalidateLuts(); // LUT registers lost, e.g. by reset or SWRESET
+    bool _lutLoaded(uint8_t command, const uint8_t* data); // true if still loaded, else recorded as loaded
     void _startTransfer();
     void _transfer(uint8_t value);
     void _endTransfer();
   protected:
     int16_t _cs, _dc, _rst, _busy, _busy_level;
+    int16_t _sda, _sck;
     uint32_t _busy_timeout;
     bool _diag_enabled, _pulldown_rst_mode;
     SPIClass* _pSPIx;
@@ -122,6 +321,31 @@ class GxEPD2_4G_EPD
     uint16_t _reset_duration;
     void (*_busy_callback)(const void*); 
     const void* _busy_callback_parameter;
+    GxEPD2_4G_Trace* _trace;
+    uint8_t _lut_command[lut_cache_size];
+    const uint8_t* _lut_loaded[lut_cache_size];
+    uint32_t _lut_uploads, _lut_uploads_skipped;
+    const LutSet* _lut_sets[4]; // selected by setLutSet(), 0 : built-in tables
+    const LutSet* _lut_registry[lut_registry_size];
+    LutMode _lut_registry_mode[lut_registry_size];
+    uint8_t _lut_registry_count;
+    uint8_t _fast_grey_max, _fast_grey_count; // _fast_grey_count reset by full grey refresh
+    int16_t _temperature, _fast_full_min_temperature, _fast_full_max_temperature;
+    uint32_t _temperature_interval;
+    unsigned long _temperature_time;
+    bool _busy_wait_deferred, _busy_wait_pending;
+    const char* _busy_comment;
+    uint16_t _busy_time;
+    unsigned long _busy_start; // micros() at start of the busy wait
+    bool _adaptive_busy_wait;
+    BusyTiming _busy_timings[busy_timings_size];
+    uint8_t _busy_timing_count;
+    uint32_t _busy_polls;
+    const EnergyFigures* _energy_figures;
+    EnergyRecord _energy_refresh, _energy_total;
+    uint32_t _energy_busy_us[energy_phases], _energy_power_on_us, _energy_spi_us, _energy_spi_bytes; // open record
+    unsigned long _energy_last, _energy_spi_start;
+    friend class GxEPD2_4G_TracePlayer;
 };
 
 #endif
@@ -0,0 +1,127 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Glyph coverage cache for anti-aliased 4 grey level text of GxEPD2_4G_4G_R.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include "GxEPD2_4G_GlyphCache.h"
+
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+#define GxEPD2_4G_read_byte(addr) pgm_read_byte(addr)
+#define GxEPD2_4G_read_word(addr) pgm_read_word(addr)
+#else
+#define GxEPD2_4G_read_byte(addr) (*(const uint8_t*)(addr))
+#define GxEPD2_4G_read_word(addr) (*(const uint16_t*)(addr))
+#endif
+
+static inline const void* GxEPD2_4G_read_pointer(const void* addr)
+{
+#if defined(__AVR)
+  return (const void*)pgm_read_word(addr);
+#elif defined(ESP8266) || defined(ESP32)
+  return (const void*)pgm_read_dword(addr);
+#else
+  return *(const void* const*)addr;
+#endif
+}
+
+// coverage 0..4 of 2x2 supersampled pixels to 4 levels
+static const uint8_t coverage_level[5] = {0, 1, 2, 2, 3};
+
+GxEPD2_4G_GlyphCache::GxEPD2_4G_GlyphCache()
+{
+  clear();
+}
+
+void GxEPD2_4G_GlyphCache::clear()
+{
+  for (uint8_t i = 0; i < entries; i++)
+  {
+    _glyphs[i].font = 0;
+    _order[i] = i;
+  }
+  _uncached.font = 0;
+  _hits = 0;
+  _misses = 0;
+}
+
+const GxEPD2_4G_GlyphCache::Glyph* GxEPD2_4G_GlyphCache::get(const GFXfont* font, uint8_t c, uint8_t phase)
+{
+  phase &= 1;
+  for (uint8_t i = 0; i < entries; i++)
+  {
+    Glyph& g = _glyphs[_order[i]];
+    if ((g.font == font) && (g.code == c) && (g.phase == phase))
+    {
+      uint8_t k = _order[i];
+      for (; i > 0; i--) _order[i] = _order[i - 1];
+      _order[0] = k;
+      _hits++;
+      return &g;
+    }
+  }
+  if ((_uncached.font == font) && (_uncached.code == c) && (_uncached.phase == phase)) return &_uncached;
+  uint8_t first = GxEPD2_4G_read_byte(&font->first);
+  if ((c < first) || (c > (uint8_t)GxEPD2_4G_read_word(&font->last))) return 0;
+  _misses++;
+  const GFXglyph* glyph = ((const GFXglyph*)GxEPD2_4G_read_pointer(&font->glyph)) + (c - first);
+  const uint8_t* bitmap = (const uint8_t*)GxEPD2_4G_read_pointer(&font->bitmap);
+  Glyph t;
+  t.font = font;
+  t.code = c;
+  t.phase = phase;
+  t.bitmap = bitmap + GxEPD2_4G_read_word(&glyph->bitmapOffset);
+  t.bitmap_width = GxEPD2_4G_read_byte(&glyph->width);
+  t.bitmap_height = GxEPD2_4G_read_byte(&glyph->height);
+  t.x_advance = GxEPD2_4G_read_byte(&glyph->xAdvance);
+  int16_t xo = phase + int8_t(GxEPD2_4G_read_byte(&glyph->xOffset));
+  int16_t yo = int8_t(GxEPD2_4G_read_byte(&glyph->yOffset));
+  t.lx = xo & 1;
+  t.ly = yo & 1;
+  t.x_offset = (xo - t.lx) / 2;
+  t.y_offset = (yo - t.ly) / 2;
+  t.width = t.bitmap_width ? (t.lx + t.bitmap_width + 1) / 2 : 0;
+  t.height = t.bitmap_height ? (t.ly + t.bitmap_height + 1) / 2 : 0;
+  t.cached = false;
+  uint16_t bytes = (uint16_t(t.width) * t.height + 3) / 4;
+  if (bytes > max_glyph_bytes)
+  {
+    _uncached = t;
+    return &_uncached;
+  }
+  uint8_t k = _order[entries - 1];
+  for (uint8_t i = entries - 1; i > 0; i--) _order[i] = _order[i - 1];
+  _order[0] = k;
+  Glyph& g = _glyphs[k];
+  g = t;
+  for (uint16_t i = 0; i < bytes; i++) g.data[i] = 0;
+  for (uint8_t y = 0; y < g.height; y++)
+  {
+    for (uint8_t x = 0; x < g.width; x++)
+    {
+      uint16_t i = x + y * g.width;
+      g.data[i / 4] |= _coverage(g, x, y) << (2 * (3 - i % 4));
+    }
+  }
+  g.cached = true;
+  return &g;
+}
+
+uint8_t GxEPD2_4G_GlyphCache::_coverage(const Glyph& g, uint8_t x, uint8_t y)
+{
+  int16_t sx = 2 * x - g.lx, sy = 2 * y - g.ly;
+  uint8_t n = _bit(g, sx, sy) + _bit(g, sx + 1, sy) + _bit(g, sx, sy + 1) + _bit(g, sx + 1, sy + 1);
+  return coverage_level[n];
+}
+
+bool GxEPD2_4G_GlyphCache::_bit(const Glyph& g, int16_t x, int16_t y)
+{
+  if ((x < 0) || (x >= g.bitmap_width) || (y < 0) || (y >= g.bitmap_height)) return false;
+  uint16_t b = x + y * g.bitmap_width; // glyph bitmaps are not padded
+  return GxEPD2_4G_read_byte(&g.bitmap[b / 8]) & (0x80 >> (b % 8));
+}
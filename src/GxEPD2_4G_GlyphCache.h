@@ -0,0 +1,70 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Glyph coverage cache for anti-aliased 4 grey level text of GxEPD2_4G_4G_R.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#ifndef _GxEPD2_4G_GlyphCache_H_
+#define _GxEPD2_4G_GlyphCache_H_
+
+#include <Adafruit_GFX.h>
+
+// GFXfonts are used as 2x2 supersampled source, e.g. FreeSans18pt7b gives anti-aliased text of about 9pt
+// coverage of each target pixel is reduced to 4 levels, 0 : background .. 3 : text color
+// the half pixel x phase of the glyph origin is part of the key, as the advance of 2x2 supersampled glyphs can be odd
+// least recently used glyphs are replaced; glyphs too big for an entry are rasterized on each use
+class GxEPD2_4G_GlyphCache
+{
+  public:
+    static const uint8_t entries = 8;
+    static const uint8_t max_glyph_bytes = 64; // 2bpp, e.g. 16 x 16 pixels
+    struct Glyph
+    {
+      const GFXfont* font;
+      uint8_t code, phase;
+      uint8_t width, height; // target pixels
+      int8_t x_offset, y_offset; // target pixels, from cursor
+      uint8_t x_advance; // supersampled pixels
+      bool cached; // coverage in data[], else from font bitmap
+      const uint8_t* bitmap; // font bitmap of glyph, supersampled
+      uint8_t bitmap_width, bitmap_height;
+      uint8_t lx, ly; // offset of font bitmap in supersampled target pixels
+      uint8_t data[max_glyph_bytes];
+      uint8_t coverage(uint8_t x, uint8_t y) const
+      {
+        if (cached)
+        {
+          uint16_t i = x + y * width;
+          return (data[i / 4] >> (2 * (3 - i % 4))) & 0x03;
+        }
+        return GxEPD2_4G_GlyphCache::_coverage(*this, x, y);
+      };
+    };
+    GxEPD2_4G_GlyphCache();
+    // returns 0 if c is not in font
+    const Glyph* get(const GFXfont* font, uint8_t c, uint8_t phase);
+    void clear();
+    uint32_t hits()
+    {
+      return _hits;
+    };
+    uint32_t misses()
+    {
+      return _misses;
+    };
+  private:
+    static uint8_t _coverage(const Glyph& g, uint8_t x, uint8_t y);
+    static bool _bit(const Glyph& g, int16_t x, int16_t y);
+  private:
+    Glyph _glyphs[entries];
+    Glyph _uncached; // metrics of last glyph too big to cache
+    uint8_t _order[entries]; // most recently used first
+    uint32_t _hits, _misses;
+};
+
+#endif
@@ -0,0 +1,178 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// One 4 grey level drawing surface over several panels, refreshed together.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include "GxEPD2_4G_MultiPanel.h"
+
+GxEPD2_4G_MultiPanel::GxEPD2_4G_MultiPanel(uint16_t w, uint16_t h, uint16_t max_panel_width, uint16_t page_height) :
+  Adafruit_GFX(w, h), _panel_count(0), _current(0), _max_panel_width(max_panel_width), _page_height(page_height), _page_y(0)
+{
+  uint32_t plane_size = uint32_t(max_panel_width / 8) * page_height;
+  _plane1 = (uint8_t*) malloc(2 * plane_size);
+  _plane2 = _plane1 ? _plane1 + plane_size : 0;
+}
+
+GxEPD2_4G_MultiPanel::~GxEPD2_4G_MultiPanel()
+{
+  if (_plane1) free(_plane1);
+}
+
+bool GxEPD2_4G_MultiPanel::addPanel(GxEPD2_4G_EPD& epd2, int16_t x, int16_t y)
+{
+  if ((_panel_count >= max_panels) || (epd2.WIDTH > _max_panel_width)) return false;
+  _panel[_panel_count].epd2 = &epd2;
+  _panel[_panel_count].x = x;
+  _panel[_panel_count].y = y;
+  _panel_count++;
+  return true;
+}
+
+void GxEPD2_4G_MultiPanel::init(uint32_t serial_diag_bitrate)
+{
+  for (uint8_t i = 0; i < _panel_count; i++)
+  {
+    _panel[i].epd2->init(serial_diag_bitrate);
+  }
+}
+
+void GxEPD2_4G_MultiPanel::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+  drawPixelLevel(x, y, GxEPD2_4G::colorLevel(color));
+}
+
+void GxEPD2_4G_MultiPanel::drawPixelLevel(int16_t x, int16_t y, uint8_t level)
+{
+  if (!_plane1 || (_current >= _panel_count) || !_toSurface(x, y)) return;
+  const Panel& panel = _panel[_current];
+  x -= panel.x;
+  y -= panel.y + _page_y;
+  if ((x < 0) || (x >= int16_t(panel.epd2->WIDTH)) || (y < 0) || (y >= _pageRows())) return;
+  uint16_t i = x / 8 + y * (panel.epd2->WIDTH / 8);
+  uint8_t mask = 0x80 >> (x % 8);
+  if (level & 0x02) _plane1[i] |= mask;
+  else _plane1[i] &= ~mask;
+  if (level & 0x01) _plane2[i] |= mask;
+  else _plane2[i] &= ~mask;
+}
+
+void GxEPD2_4G_MultiPanel::fillScreen(uint16_t color)
+{
+  _fillPage(GxEPD2_4G::colorLevel(color));
+}
+
+void GxEPD2_4G_MultiPanel::firstPage()
+{
+  _current = 0;
+  _page_y = 0;
+  _fillPage(3);
+}
+
+bool GxEPD2_4G_MultiPanel::nextPage()
+{
+  if (_current >= _panel_count) return false;
+  GxEPD2_4G_EPD& epd2 = *_panel[_current].epd2;
+  if (_plane1)
+  {
+    int16_t rows = _pageRows();
+    epd2.writeNativePart_4G(_plane1, _plane2, 0, 0, epd2.WIDTH, rows, 0, _page_y, epd2.WIDTH, rows);
+  }
+  _page_y += _page_height;
+  if (_page_y >= int16_t(epd2.HEIGHT))
+  {
+    _page_y = 0;
+    _current++;
+  }
+  if (_current >= _panel_count)
+  {
+    refresh();
+    return false;
+  }
+  _fillPage(3);
+  return true;
+}
+
+void GxEPD2_4G_MultiPanel::pageArea(int16_t& x, int16_t& y, int16_t& w, int16_t& h)
+{
+  x = y = w = h = 0;
+  if (_current >= _panel_count) return;
+  const Panel& panel = _panel[_current];
+  x = panel.x;
+  y = panel.y + _page_y;
+  w = panel.epd2->WIDTH;
+  h = _pageRows();
+}
+
+void GxEPD2_4G_MultiPanel::refresh()
+{
+  // start all refreshes, then wait; a panel's wait is finished before anything else is sent to it
+  for (uint8_t i = 0; i < _panel_count; i++)
+  {
+    _panel[i].epd2->setDeferredBusyWait(true);
+    _panel[i].epd2->refresh(false);
+  }
+  for (uint8_t i = 0; i < _panel_count; i++)
+  {
+    _panel[i].epd2->setDeferredBusyWait(false);
+  }
+}
+
+void GxEPD2_4G_MultiPanel::powerOff()
+{
+  for (uint8_t i = 0; i < _panel_count; i++)
+  {
+    _panel[i].epd2->powerOff();
+  }
+}
+
+void GxEPD2_4G_MultiPanel::hibernate()
+{
+  for (uint8_t i = 0; i < _panel_count; i++)
+  {
+    _panel[i].epd2->hibernate();
+  }
+}
+
+bool GxEPD2_4G_MultiPanel::_toSurface(int16_t& x, int16_t& y) const
+{
+  if ((x < 0) || (x >= width()) || (y < 0) || (y >= height())) return false;
+  int16_t t;
+  switch (getRotation())
+  {
+    case 1:
+      t = x;
+      x = WIDTH - 1 - y;
+      y = t;
+      break;
+    case 2:
+      x = WIDTH - 1 - x;
+      y = HEIGHT - 1 - y;
+      break;
+    case 3:
+      t = x;
+      x = y;
+      y = HEIGHT - 1 - t;
+      break;
+  }
+  return true;
+}
+
+void GxEPD2_4G_MultiPanel::_fillPage(uint8_t level)
+{
+  if (!_plane1) return;
+  uint32_t plane_size = uint32_t(_max_panel_width / 8) * _page_height;
+  memset(_plane1, level & 0x02 ? 0xFF : 0x00, plane_size);
+  memset(_plane2, level & 0x01 ? 0xFF : 0x00, plane_size);
+}
+
+int16_t GxEPD2_4G_MultiPanel::_pageRows()
+{
+  int16_t rows = _panel[_current].epd2->HEIGHT - _page_y;
+  return rows < int16_t(_page_height) ? rows : _page_height;
+}
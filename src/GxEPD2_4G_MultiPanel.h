@@ -0,0 +1,74 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// One 4 grey level drawing surface over several panels, refreshed together.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#ifndef _GxEPD2_4G_MultiPanel_H_
+#define _GxEPD2_4G_MultiPanel_H_
+
+#include <Adafruit_GFX.h>
+#include "GxEPD2_4G_EPD.h"
+
+// e.g. a wall board of 2 to 4 panels with their own CS, DC, RST and BUSY pins, on a shared or separate SPI bus
+// each panel is placed at a position of the surface, in controller orientation; rotation applies to the surface
+// drawing is paged, like firstPage() / nextPage() of GxEPD2_4G_4G: the pages of each panel in turn, written
+// to controller memory by writeNativePart_4G(); the last nextPage() refreshes all panels with overlapped BUSY
+// panels of different controllers can be mixed, writeNativePart_4G() converts the planes to controller polarity
+// the page buffer is allocated by the constructor, 2 planes of max_panel_width / 8 * page_height bytes; check for 0
+class GxEPD2_4G_MultiPanel : public Adafruit_GFX
+{
+  public:
+    static const uint8_t max_panels = 4;
+    GxEPD2_4G_MultiPanel(uint16_t w, uint16_t h, uint16_t max_panel_width = 800, uint16_t page_height = 16);
+    ~GxEPD2_4G_MultiPanel();
+    // returns false if max_panels reached, or the panel is wider than max_panel_width
+    bool addPanel(GxEPD2_4G_EPD& epd2, int16_t x, int16_t y);
+    uint8_t panels()
+    {
+      return _panel_count;
+    };
+    bool hasBuffer()
+    {
+      return _plane1 != 0;
+    };
+    void init(uint32_t serial_diag_bitrate = 0); // init of all panels
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+    void drawPixelLevel(int16_t x, int16_t y, uint8_t level); // 0 : black, 1 : dark grey, 2 : light grey, 3 : white
+    void fillScreen(uint16_t color);
+    void firstPage();
+    bool nextPage(); // false after the last page of the last panel, all panels refreshed
+    // panel and area of the surface of the current page, e.g. to skip drawing outside
+    uint8_t pagePanel()
+    {
+      return _current;
+    };
+    void pageArea(int16_t& x, int16_t& y, int16_t& w, int16_t& h);
+    // full grey refresh of all panels, started one after the other, then waits for all; needs no page buffer
+    void refresh();
+    void powerOff();
+    void hibernate();
+  private:
+    bool _toSurface(int16_t& x, int16_t& y) const;
+    void _fillPage(uint8_t level);
+    int16_t _pageRows();
+  private:
+    struct Panel
+    {
+      GxEPD2_4G_EPD* epd2;
+      int16_t x, y;
+    };
+    Panel _panel[max_panels];
+    uint8_t _panel_count, _current;
+    uint16_t _max_panel_width, _page_height;
+    int16_t _page_y; // controller row of the current page
+    uint8_t* _plane1;
+    uint8_t* _plane2;
+};
+
+#endif
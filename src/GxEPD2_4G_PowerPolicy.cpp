@@ -0,0 +1,81 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Power policy for the GFX classes, decides when panel driving voltages are turned off after full refresh.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include "GxEPD2_4G_PowerPolicy.h"
+#include "GxEPD2_4G_EPD.h"
+
+GxEPD2_4G_PowerPolicy::GxEPD2_4G_PowerPolicy(GxEPD2_4G_EPD& epd2, Mode mode, uint32_t quiet_time_ms) : _epd2(epd2)
+{
+  _mode = mode;
+  _quiet_time_ms = quiet_time_ms;
+  _last_update_ms = 0;
+  _in_burst = false;
+  _power_off_pending = false;
+  _power_offs_avoided = 0;
+}
+
+void GxEPD2_4G_PowerPolicy::setMode(Mode mode, uint32_t quiet_time_ms)
+{
+  _mode = mode;
+  _quiet_time_ms = quiet_time_ms;
+  if ((_mode == always_off) && !_in_burst && _pending()) _powerOff();
+}
+
+void GxEPD2_4G_PowerPolicy::beginBurst()
+{
+  _in_burst = true;
+}
+
+void GxEPD2_4G_PowerPolicy::endBurst()
+{
+  _in_burst = false;
+  _last_update_ms = millis(); // quiet time starts now
+  if (_pending() && (_quiet_time_ms == 0)) _powerOff();
+}
+
+void GxEPD2_4G_PowerPolicy::loop()
+{
+  if (_in_burst || !_pending()) return;
+  if (millis() - _last_update_ms >= _quiet_time_ms) _powerOff();
+}
+
+void GxEPD2_4G_PowerPolicy::updated()
+{
+  if (_in_burst || (_mode == idle_timeout))
+  {
+    _last_update_ms = millis();
+    if (_power_off_pending) _power_offs_avoided++; // not cleared by poweredOff() since the previous refresh
+    _power_off_pending = _epd2.isPowerOn(); // some controllers power off at the end of full refresh
+  }
+  else _powerOff();
+}
+
+void GxEPD2_4G_PowerPolicy::poweredOff()
+{
+  _power_off_pending = false;
+}
+
+bool GxEPD2_4G_PowerPolicy::powerOffPending()
+{
+  return _pending();
+}
+
+bool GxEPD2_4G_PowerPolicy::_pending()
+{
+  if (_power_off_pending && !_epd2.isPowerOn()) _power_off_pending = false;
+  return _power_off_pending;
+}
+
+void GxEPD2_4G_PowerPolicy::_powerOff()
+{
+  _epd2.powerOff();
+  _power_off_pending = false;
+}
@@ -0,0 +1,52 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Power policy for the GFX classes, decides when panel driving voltages are turned off after full refresh.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#ifndef _GxEPD2_4G_PowerPolicy_H_
+#define _GxEPD2_4G_PowerPolicy_H_
+
+#include <Arduino.h>
+
+class GxEPD2_4G_EPD;
+
+// without power policy the GFX classes turn power off after each full refresh (always_off)
+// always_off   : power off after each full refresh, except inside a burst
+// idle_timeout : keep power on, power off after quiet_time_ms without full refresh
+// a burst (beginBurst() ... endBurst()) keeps power on in any mode, power off follows quiet_time_ms after endBurst()
+// loop() needs to be called regularly for timed power off, e.g. from loop() of the sketch
+class GxEPD2_4G_PowerPolicy
+{
+  public:
+    enum Mode {always_off, idle_timeout};
+    GxEPD2_4G_PowerPolicy(GxEPD2_4G_EPD& epd2, Mode mode = always_off, uint32_t quiet_time_ms = 0);
+    void setMode(Mode mode, uint32_t quiet_time_ms = 0);
+    void beginBurst();
+    void endBurst(); // powers off now if quiet_time_ms is 0
+    void loop(); // powers off if quiet time has expired
+    void updated(); // called by the GFX classes after full refresh, instead of powerOff()
+    void poweredOff(); // called by the GFX classes on powerOff() and hibernate()
+    bool powerOffPending(); // power kept on by the policy and still on
+    uint32_t powerOffsAvoided() // full refreshes that found power still on from the previous one
+    {
+      return _power_offs_avoided;
+    };
+  private:
+    void _powerOff();
+    bool _pending(); // clears a pending power off if power is off, e.g. by epd2.powerOff()
+  private:
+    GxEPD2_4G_EPD& _epd2;
+    Mode _mode;
+    uint32_t _quiet_time_ms;
+    unsigned long _last_update_ms;
+    bool _in_burst, _power_off_pending;
+    uint32_t _power_offs_avoided;
+};
+
+#endif
@@ -0,0 +1,206 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Command trace capture and playback, for comparing what different library versions send to a panel.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#include "GxEPD2_4G_Trace.h"
+#include "GxEPD2_4G_EPD.h"
+
+GxEPD2_4G_Trace::GxEPD2_4G_Trace(Print& out) : _out(out)
+{
+  _last_us = 0;
+  _bytes_logged = 0;
+  _data_bytes = 0;
+  _busy_time = 0;
+  _run_type = DATA;
+  _run_count = 0;
+}
+
+void GxEPD2_4G_Trace::begin(uint8_t panel, uint16_t width, uint16_t height)
+{
+  _run_count = 0;
+  _write('G');
+  _write('x');
+  _write('T');
+  _write(version);
+  _write(panel);
+  _write(width % 256);
+  _write(width / 256);
+  _write(height % 256);
+  _write(height / 256);
+  _last_us = micros();
+}
+
+void GxEPD2_4G_Trace::command(uint8_t c)
+{
+  flush();
+  _record(CMD);
+  _write(c);
+}
+
+void GxEPD2_4G_Trace::data(uint8_t d)
+{
+  _runByte(DATA, d);
+}
+
+void GxEPD2_4G_Trace::data(const uint8_t* d, uint16_t n)
+{
+  for (uint16_t i = 0; i < n; i++)
+  {
+    data(d[i]);
+  }
+}
+
+void GxEPD2_4G_Trace::dataSCS(uint8_t d)
+{
+  _runByte(DATA_SCS, d);
+}
+
+void GxEPD2_4G_Trace::busy(uint32_t duration_us)
+{
+  flush();
+  _record(BUSY);
+  _writeVarint(duration_us);
+  _busy_time += duration_us;
+}
+
+void GxEPD2_4G_Trace::reset()
+{
+  flush();
+  _record(RESET);
+}
+
+void GxEPD2_4G_Trace::flush()
+{
+  if (_run_count == 0) return;
+  _record(_run_type);
+  _write(_run_count);
+  for (uint8_t i = 0; i < _run_count; i++)
+  {
+    _write(_run[i]);
+  }
+  _run_count = 0;
+}
+
+void GxEPD2_4G_Trace::_runByte(uint8_t type, uint8_t d)
+{
+  if ((_run_count == sizeof(_run)) || (type != _run_type)) flush();
+  _run_type = type;
+  _run[_run_count++] = d;
+  _data_bytes++;
+}
+
+void GxEPD2_4G_Trace::_record(uint8_t type)
+{
+  unsigned long now = micros();
+  _write(type);
+  _writeVarint(now - _last_us);
+  _last_us = now;
+}
+
+void GxEPD2_4G_Trace::_writeVarint(uint32_t value)
+{
+  while (value >= 0x80)
+  {
+    _write(uint8_t(value) | 0x80);
+    value >>= 7;
+  }
+  _write(uint8_t(value));
+}
+
+void GxEPD2_4G_Trace::_write(uint8_t b)
+{
+  _out.write(b);
+  _bytes_logged++;
+}
+
+GxEPD2_4G_TracePlayer::GxEPD2_4G_TracePlayer(GxEPD2_4G_EPD& epd2) : _epd2(epd2)
+{
+  _records = 0;
+}
+
+bool GxEPD2_4G_TracePlayer::play(Stream& in, bool timed)
+{
+  _records = 0;
+  uint8_t header[9];
+  if (in.readBytes(header, sizeof(header)) != sizeof(header)) return false;
+  if ((header[0] != 'G') || (header[1] != 'x') || (header[2] != 'T')) return false;
+  if ((header[3] < 1) || (header[3] > GxEPD2_4G_Trace::version)) return false;
+  while (1)
+  {
+    int type = _read(in);
+    if (type < 0) return true; // end of log
+    uint32_t delta;
+    if (!_readVarint(in, delta)) return false;
+    if (timed && (delta > 0) && (type != GxEPD2_4G_Trace::BUSY)) // BUSY delta includes the busy time, replayed by the wait
+    {
+      if (delta >= 1000) delay(delta / 1000);
+      delayMicroseconds(delta % 1000);
+    }
+    switch (type)
+    {
+      case GxEPD2_4G_Trace::CMD:
+        {
+          int c = _read(in);
+          if (c < 0) return false;
+          _epd2._writeCommand(c);
+        }
+        break;
+      case GxEPD2_4G_Trace::DATA:
+      case GxEPD2_4G_Trace::DATA_SCS:
+        {
+          int n = _read(in);
+          if (n < 0) return false;
+          uint8_t run[32];
+          while (n > 0)
+          {
+            uint8_t chunk = n < int(sizeof(run)) ? n : sizeof(run);
+            if (in.readBytes(run, chunk) != chunk) return false;
+            if (type == GxEPD2_4G_Trace::DATA_SCS) _epd2._writeData_sCS(run, chunk);
+            else _epd2._writeData(run, chunk);
+            n -= chunk;
+          }
+        }
+        break;
+      case GxEPD2_4G_Trace::BUSY:
+        {
+          uint32_t duration;
+          if (!_readVarint(in, duration)) return false;
+          _epd2._waitWhileBusy("replay", (duration + 999) / 1000);
+        }
+        break;
+      case GxEPD2_4G_Trace::RESET:
+        _epd2._reset();
+        break;
+      default:
+        return false;
+    }
+    _records++;
+  }
+}
+
+int GxEPD2_4G_TracePlayer::_read(Stream& in)
+{
+  uint8_t b;
+  if (in.readBytes(&b, 1) != 1) return -1;
+  return b;
+}
+
+bool GxEPD2_4G_TracePlayer::_readVarint(Stream& in, uint32_t& value)
+{
+  value = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7)
+  {
+    int b = _read(in);
+    if (b < 0) return false;
+    value |= uint32_t(b & 0x7F) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
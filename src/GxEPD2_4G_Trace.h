@@ -0,0 +1,89 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Command trace capture and playback, for comparing what different library versions send to a panel.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2_4G
+
+#ifndef _GxEPD2_4G_Trace_H_
+#define _GxEPD2_4G_Trace_H_
+
+#include <Arduino.h>
+
+class GxEPD2_4G_EPD;
+
+// compact binary trace log, written to any Print (Serial, SD File, LittleFS File, ...)
+// header : 'G', 'x', 'T', version, panel, WIDTH (2 bytes LE), HEIGHT (2 bytes LE)
+// record : type, time since previous record in us (varint), payload
+//   CMD   : command byte
+//   DATA  : count (1..255), data bytes
+//   DATA_SCS : as DATA, each byte in its own chip select, e.g. LUT uploads of GxEPD2_270
+//   BUSY  : busy duration in us (varint), time waited for BUSY or delay if no BUSY pin; recorded at the end of the
+//           wait, the time since the previous record includes the busy duration
+//   RESET : no payload
+class GxEPD2_4G_Trace
+{
+  public:
+    enum RecordType {CMD = 0x01, DATA = 0x02, BUSY = 0x03, RESET = 0x04, DATA_SCS = 0x05};
+    static const uint8_t version = 2; // version 1 logs have no DATA_SCS records, played as well
+    GxEPD2_4G_Trace(Print& out);
+    void begin(uint8_t panel, uint16_t width, uint16_t height); // writes header, called by GxEPD2_4G_EPD::setTrace()
+    void command(uint8_t c);
+    void data(uint8_t d);
+    void data(const uint8_t* d, uint16_t n);
+    void dataSCS(uint8_t d); // data byte sent with its own chip select
+    void busy(uint32_t duration_us);
+    void reset();
+    void flush(); // writes pending data run, call before closing the log
+    uint32_t bytesLogged()
+    {
+      return _bytes_logged;
+    };
+    uint32_t dataBytes() // data bytes sent to the controller
+    {
+      return _data_bytes;
+    };
+    uint32_t busyTime() // sum of busy durations in us
+    {
+      return _busy_time;
+    };
+  private:
+    void _runByte(uint8_t type, uint8_t d);
+    void _record(uint8_t type);
+    void _writeVarint(uint32_t value);
+    void _write(uint8_t b);
+  private:
+    Print& _out;
+    unsigned long _last_us;
+    uint32_t _bytes_logged, _data_bytes, _busy_time;
+    uint8_t _run_type, _run_count;
+    uint8_t _run[32];
+};
+
+// replays a trace log through the transport of a driver instance, e.g. on real hardware
+// the driver instance must be initialized by init() before play()
+class GxEPD2_4G_TracePlayer
+{
+  public:
+    GxEPD2_4G_TracePlayer(GxEPD2_4G_EPD& epd2);
+    // returns false on bad header or truncated log
+    // timed true : keep the recorded time between records, else send as fast as possible
+    // BUSY records wait for the BUSY pin of the target, or delay the recorded time if no BUSY pin
+    bool play(Stream& in, bool timed = false);
+    uint32_t records()
+    {
+      return _records;
+    };
+  private:
+    int _read(Stream& in);
+    bool _readVarint(Stream& in, uint32_t& value);
+  private:
+    GxEPD2_4G_EPD& _epd2;
+    uint32_t _records;
+};
+
+#endif
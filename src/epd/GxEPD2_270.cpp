@@ -13,7 +13,7 @@
 #include "GxEPD2_270.h"
 
 GxEPD2_270::GxEPD2_270(int16_t cs, int16_t dc, int16_t rst, int16_t busy) :
-  GxEPD2_4G_EPD(cs, dc, rst, busy, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate)
+  GxEPD2_4G_EPD(cs, dc, rst, busy, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate, hasPartialUpdateWindow_4G)
 {
   _refresh_mode = full_refresh;
 }
@@ -312,6 +312,50 @@ void GxEPD2_270::writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int16_t
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
 
+void GxEPD2_270::writeNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                    int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+  if ((w_bitmap < 0) || (h_bitmap < 0) || (w < 0) || (h < 0)) return;
+  if ((x_part < 0) || (x_part >= w_bitmap)) return;
+  if ((y_part < 0) || (y_part >= h_bitmap)) return;
+  int16_t wb_bitmap = (w_bitmap + 7) / 8; // width bytes, bitmaps are padded
+  x_part -= x_part % 8; // byte boundary
+  w = w_bitmap - x_part < w ? w_bitmap - x_part : w; // limit
+  h = h_bitmap - y_part < h ? h_bitmap - y_part : h; // limit
+  int16_t wbc = (w + 7) / 8; // width bytes on controller
+  x -= x % 8; // byte boundary on controller
+  w = wbc * 8; // byte boundary on controller
+  int16_t x1 = x < 0 ? 0 : x; // limit
+  int16_t y1 = y < 0 ? 0 : y; // limit
+  uint16_t w1 = x + w < int16_t(WIDTH) ? w : int16_t(WIDTH) - x; // limit
+  uint16_t h1 = y + h < int16_t(HEIGHT) ? h : int16_t(HEIGHT) - y; // limit
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if ((w1 <= 0) || (h1 <= 0)) return;
+  _Init_4G();
+  _setPartialRamArea(0x14, x1, y1, w1, h1);
+  _startTransfer();
+  for (uint16_t i = 0; i < h1; i++) // lines
+  {
+    const uint8_t* line = plane1 + x_part / 8 + dx / 8 + uint32_t(y_part + i + dy) * wb_bitmap;
+    for (uint16_t j = 0; j < w1 / 8; j++) _transfer(line[j]);
+  }
+  _endTransfer();
+  _setPartialRamArea(0x15, x1, y1, w1, h1);
+  _startTransfer();
+  for (uint16_t i = 0; i < h1; i++) // lines
+  {
+    const uint8_t* line = plane2 + x_part / 8 + dx / 8 + uint32_t(y_part + i + dy) * wb_bitmap;
+    for (uint16_t j = 0; j < w1 / 8; j++) _transfer(line[j]);
+  }
+  _endTransfer();
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+}
+
 void GxEPD2_270::writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                                 int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
@@ -484,12 +528,9 @@ void GxEPD2_270::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
   if (w1 % 8 > 0) w1 += 8 - w1 % 8;
   x1 -= x1 % 8;
   if (_refresh_mode == full_refresh) _Init_Part();
-  if (_refresh_mode == grey_refresh) _Update_4G();
-  else
-  {
-    _refreshWindow(x1, y1, w1, h1);
-    _waitWhileBusy("refresh", partial_refresh_time);
-  }
+  _refreshWindow(x1, y1, w1, h1); // partial refresh with current LUTs, b/w or grey
+  if (_refresh_mode == grey_refresh) _waitWhileBusy("refresh 4G", full_refresh_time);
+  else _waitWhileBusy("refresh", partial_refresh_time);
 }
 
 void GxEPD2_270::powerOff(void)
@@ -766,16 +807,11 @@ void GxEPD2_270::_Init_Full()
   _InitDisplay();
   _writeCommand(0x50); //VCOM AND DATA INTERVAL SETTING
   _writeData(0x97);    //WBmode:VBDF 17|D7 VBDW 97 VBDB 57   WBRmode:VBDF F7 VBDW 77 VBDB 37  VBDR B7
-  _writeCommand(0x20);
-  _writeDataPGM_sCS(lut_20_vcomDC, sizeof(lut_20_vcomDC));
-  _writeCommand(0x21);
-  _writeDataPGM_sCS(lut_21_ww, sizeof(lut_21_ww));
-  _writeCommand(0x22);
-  _writeDataPGM_sCS(lut_22_bw, sizeof(lut_22_bw));
-  _writeCommand(0x23);
-  _writeDataPGM_sCS(lut_23_wb, sizeof(lut_23_wb));
-  _writeCommand(0x24);
-  _writeDataPGM_sCS(lut_24_bb, sizeof(lut_24_bb));
+  _writeLutPGM_sCS(0x20, lut_20_vcomDC, sizeof(lut_20_vcomDC));
+  _writeLutPGM_sCS(0x21, lut_21_ww, sizeof(lut_21_ww));
+  _writeLutPGM_sCS(0x22, lut_22_bw, sizeof(lut_22_bw));
+  _writeLutPGM_sCS(0x23, lut_23_wb, sizeof(lut_23_wb));
+  _writeLutPGM_sCS(0x24, lut_24_bb, sizeof(lut_24_bb));
   _PowerOn();
   _refresh_mode = full_refresh;
 }
@@ -785,16 +821,11 @@ void GxEPD2_270::_Init_4G()
   _InitDisplay();
   _writeCommand(0x50); //VCOM AND DATA INTERVAL SETTING
   _writeData(0x17);    //WBmode:VBDF 17|D7 VBDW 97 VBDB 57   WBRmode:VBDF F7 VBDW 77 VBDB 37  VBDR B7
-  _writeCommand(0x20);
-  _writeDataPGM_sCS(lut_20_vcom0_4G, sizeof(lut_20_vcom0_4G));
-  _writeCommand(0x21);
-  _writeDataPGM_sCS(lut_21_ww_4G, sizeof(lut_21_ww_4G));
-  _writeCommand(0x22);
-  _writeDataPGM_sCS(lut_22_bw_4G, sizeof(lut_22_bw_4G));
-  _writeCommand(0x23);
-  _writeDataPGM_sCS(lut_23_wb_4G, sizeof(lut_23_wb_4G));
-  _writeCommand(0x24);
-  _writeDataPGM_sCS(lut_24_bb_4G, sizeof(lut_24_bb_4G));
+  _writeLutPGM_sCS(0x20, lut_20_vcom0_4G, sizeof(lut_20_vcom0_4G));
+  _writeLutPGM_sCS(0x21, lut_21_ww_4G, sizeof(lut_21_ww_4G));
+  _writeLutPGM_sCS(0x22, lut_22_bw_4G, sizeof(lut_22_bw_4G));
+  _writeLutPGM_sCS(0x23, lut_23_wb_4G, sizeof(lut_23_wb_4G));
+  _writeLutPGM_sCS(0x24, lut_24_bb_4G, sizeof(lut_24_bb_4G));
   _PowerOn();
   _refresh_mode = grey_refresh;
 }
@@ -804,16 +835,11 @@ void GxEPD2_270::_Init_Part()
   _InitDisplay();
   _writeCommand(0x50); //VCOM AND DATA INTERVAL SETTING
   _writeData(0x17);    //WBmode:VBDF 17|D7 VBDW 97 VBDB 57   WBRmode:VBDF F7 VBDW 77 VBDB 37  VBDR B7
-  _writeCommand(0x20);
-  _writeDataPGM_sCS(lut_20_vcomDC_partial, sizeof(lut_20_vcomDC_partial));
-  _writeCommand(0x21);
-  _writeDataPGM_sCS(lut_21_ww_partial, sizeof(lut_21_ww_partial));
-  _writeCommand(0x22);
-  _writeDataPGM_sCS(lut_22_bw_partial, sizeof(lut_22_bw_partial));
-  _writeCommand(0x23);
-  _writeDataPGM_sCS(lut_23_wb_partial, sizeof(lut_23_wb_partial));
-  _writeCommand(0x24);
-  _writeDataPGM_sCS(lut_24_bb_partial, sizeof(lut_24_bb_partial));
+  _writeLutPGM_sCS(0x20, lut_20_vcomDC_partial, sizeof(lut_20_vcomDC_partial));
+  _writeLutPGM_sCS(0x21, lut_21_ww_partial, sizeof(lut_21_ww_partial));
+  _writeLutPGM_sCS(0x22, lut_22_bw_partial, sizeof(lut_22_bw_partial));
+  _writeLutPGM_sCS(0x23, lut_23_wb_partial, sizeof(lut_23_wb_partial));
+  _writeLutPGM_sCS(0x24, lut_24_bb_partial, sizeof(lut_24_bb_partial));
   _PowerOn();
   _refresh_mode = fast_refresh;
 }
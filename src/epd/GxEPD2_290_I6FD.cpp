@@ -14,7 +14,7 @@
 #include "GxEPD2_290_I6FD.h"
 
 GxEPD2_290_I6FD::GxEPD2_290_I6FD(int16_t cs, int16_t dc, int16_t rst, int16_t busy) :
-  GxEPD2_4G_EPD(cs, dc, rst, busy, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate)
+  GxEPD2_4G_EPD(cs, dc, rst, busy, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate, hasPartialUpdateWindow_4G)
 {
   _refresh_mode = full_refresh;
 }
@@ -363,6 +363,52 @@ void GxEPD2_290_I6FD::writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
 
+void GxEPD2_290_I6FD::writeNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                         int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+  if ((w_bitmap < 0) || (h_bitmap < 0) || (w < 0) || (h < 0)) return;
+  if ((x_part < 0) || (x_part >= w_bitmap)) return;
+  if ((y_part < 0) || (y_part >= h_bitmap)) return;
+  int16_t wb_bitmap = (w_bitmap + 7) / 8; // width bytes, bitmaps are padded
+  x_part -= x_part % 8; // byte boundary
+  w = w_bitmap - x_part < w ? w_bitmap - x_part : w; // limit
+  h = h_bitmap - y_part < h ? h_bitmap - y_part : h; // limit
+  x -= x % 8; // byte boundary
+  w = 8 * ((w + 7) / 8); // byte boundary, bitmaps are padded
+  int16_t x1 = x < 0 ? 0 : x; // limit
+  int16_t y1 = y < 0 ? 0 : y; // limit
+  uint16_t w1 = x + w < int16_t(WIDTH) ? w : int16_t(WIDTH) - x; // limit
+  uint16_t h1 = y + h < int16_t(HEIGHT) ? h : int16_t(HEIGHT) - y; // limit
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if ((w1 <= 0) || (h1 <= 0)) return;
+  _Init_4G();
+  _writeCommand(0x91); // partial in
+  _setPartialRamArea(x1, y1, w1, h1);
+  _writeCommand(0x10);
+  _startTransfer();
+  for (uint16_t i = 0; i < h1; i++) // lines
+  {
+    const uint8_t* line = plane1 + x_part / 8 + dx / 8 + uint32_t(y_part + i + dy) * wb_bitmap;
+    for (uint16_t j = 0; j < w1 / 8; j++) _transfer(line[j]);
+  }
+  _endTransfer();
+  _writeCommand(0x13);
+  _startTransfer();
+  for (uint16_t i = 0; i < h1; i++) // lines
+  {
+    const uint8_t* line = plane2 + x_part / 8 + dx / 8 + uint32_t(y_part + i + dy) * wb_bitmap;
+    for (uint16_t j = 0; j < w1 / 8; j++) _transfer(line[j]);
+  }
+  _endTransfer();
+  _writeCommand(0x92); // partial out
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+}
+
 void GxEPD2_290_I6FD::writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   if (black)
@@ -677,16 +723,11 @@ void GxEPD2_290_I6FD::_Init_4G()
   _writeData(0xbf);    //LUT from register, 128x296
   _writeCommand(0x50);
   _writeData(0x17);    //WBmode:VBDF 17|D7 VBDW 97 VBDB 57   WBRmode:VBDF F7 VBDW 77 VBDB 37  VBDR B7
-  _writeCommand(0x20);
-  _writeDataPGM(lut_20_vcom0_4G, sizeof(lut_20_vcom0_4G));
-  _writeCommand(0x21);
-  _writeDataPGM(lut_21_ww_4G, sizeof(lut_21_ww_4G));
-  _writeCommand(0x22);
-  _writeDataPGM(lut_22_bw_4G, sizeof(lut_22_bw_4G));
-  _writeCommand(0x23);
-  _writeDataPGM(lut_23_wb_4G, sizeof(lut_23_wb_4G));
-  _writeCommand(0x24);
-  _writeDataPGM(lut_24_bb_4G, sizeof(lut_24_bb_4G));
+  _writeLutPGM(0x20, lut_20_vcom0_4G, sizeof(lut_20_vcom0_4G));
+  _writeLutPGM(0x21, lut_21_ww_4G, sizeof(lut_21_ww_4G));
+  _writeLutPGM(0x22, lut_22_bw_4G, sizeof(lut_22_bw_4G));
+  _writeLutPGM(0x23, lut_23_wb_4G, sizeof(lut_23_wb_4G));
+  _writeLutPGM(0x24, lut_24_bb_4G, sizeof(lut_24_bb_4G));
   _PowerOn();
   _refresh_mode = grey_refresh;
 }
@@ -700,16 +741,11 @@ void GxEPD2_290_I6FD::_Init_Part()
   _writeData (0x08);
   _writeCommand(0x50);
   _writeData(0x17);    //WBmode:VBDF 17|D7 VBDW 97 VBDB 57   WBRmode:VBDF F7 VBDW 77 VBDB 37  VBDR B7
-  _writeCommand(0x20);
-  _writeDataPGM(lut_20_vcomDC_partial, sizeof(lut_20_vcomDC_partial));
-  _writeCommand(0x21);
-  _writeDataPGM(lut_21_ww_partial, sizeof(lut_21_ww_partial));
-  _writeCommand(0x22);
-  _writeDataPGM(lut_22_bw_partial, sizeof(lut_22_bw_partial));
-  _writeCommand(0x23);
-  _writeDataPGM(lut_23_wb_partial, sizeof(lut_23_wb_partial));
-  _writeCommand(0x24);
-  _writeDataPGM(lut_24_bb_partial, sizeof(lut_24_bb_partial));
+  _writeLutPGM(0x20, lut_20_vcomDC_partial, sizeof(lut_20_vcomDC_partial));
+  _writeLutPGM(0x21, lut_21_ww_partial, sizeof(lut_21_ww_partial));
+  _writeLutPGM(0x22, lut_22_bw_partial, sizeof(lut_22_bw_partial));
+  _writeLutPGM(0x23, lut_23_wb_partial, sizeof(lut_23_wb_partial));
+  _writeLutPGM(0x24, lut_24_bb_partial, sizeof(lut_24_bb_partial));
   _PowerOn();
   _refresh_mode = fast_refresh;
 }
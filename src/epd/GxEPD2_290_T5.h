@@ -25,6 +25,7 @@ class GxEPD2_290_T5 : public GxEPD2_4G_EPD
     static const bool hasColor = false;
     static const bool hasPartialUpdate = true;
     static const bool hasFastPartialUpdate = true; // set this false for test with OTP LUT (GDEW029I6F)
+    static const bool hasPartialUpdateWindow_4G = true; // grey partial refresh limited to window
     static const uint16_t power_on_time = 400; // ms, e.g. 36553us
     static const uint16_t power_off_time = 250; // ms, e.g. 20759us
     static const uint16_t full_refresh_time = 2100; // ms, e.g. 2056899us
@@ -42,6 +43,9 @@ class GxEPD2_290_T5 : public GxEPD2_4G_EPD
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+    // write two 1bpp planes, native format of 4 grey level write, see GxEPD2_4G_EPD
+    void writeNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                            int16_t x, int16_t y, int16_t w, int16_t h);
     void writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void writeImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
@@ -75,6 +79,14 @@ class GxEPD2_290_T5 : public GxEPD2_4G_EPD
     void _Update_Full();
     void _Update_4G();
     void _Update_Part();
+    uint8_t _saveDriverState()
+    {
+      return _refresh_mode;
+    };
+    void _restoreDriverState(uint8_t state)
+    {
+      _refresh_mode = decltype(_refresh_mode)(state);
+    };
   private:
     enum {full_refresh, grey_refresh, fast_refresh, forced_full_refresh} _refresh_mode;
     static const unsigned char lut_20_vcomDC[];
@@ -14,7 +14,7 @@
 #include "GxEPD2_290_T94.h"
 
 GxEPD2_290_T94::GxEPD2_290_T94(int16_t cs, int16_t dc, int16_t rst, int16_t busy) :
-  GxEPD2_4G_EPD(cs, dc, rst, busy, HIGH, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate)
+  GxEPD2_4G_EPD(cs, dc, rst, busy, HIGH, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate, hasPartialUpdateWindow_4G)
 {
   _refresh_mode = full_refresh;
 }
@@ -99,9 +99,10 @@ void GxEPD2_290_T94::_writeImage(uint8_t command, const uint8_t bitmap[], int16_
   w1 -= dx;
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
+  int16_t sy = mirror_y ? h - h1 - dy : dy; // first source line, lines are written in reverse order if mirror_y
   if (_refresh_mode == grey_refresh) _Force_Init_Full();
   else if (_refresh_mode == full_refresh) _Init_Part();
-  _setPartialRamArea(x1, y1, w1, h1);
+  _setPartialRamArea(x1, y1, w1, h1, mirror_y);
   _writeCommand(command);
   for (uint16_t i = 0; i < h1; i++)
   {
@@ -109,7 +110,7 @@ void GxEPD2_290_T94::_writeImage(uint8_t command, const uint8_t bitmap[], int16_
     {
       uint8_t data;
       // use wb, h of bitmap for index!
-      int16_t idx = mirror_y ? j + dx / 8 + ((h - 1 - (i + dy))) * wb : j + dx / 8 + (i + dy) * wb;
+      int16_t idx = j + dx / 8 + (i + sy) * wb;
       if (pgm)
       {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -150,8 +151,9 @@ void GxEPD2_290_T94::writeImage_4G(const uint8_t bitmap[], uint8_t bpp, int16_t
   w1 -= dx;
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
-  _Init_4G();
-  _setPartialRamArea(x1, y1, w1, h1);
+  int16_t sy = mirror_y ? h - h1 - dy : dy; // first source line, lines are written in reverse order if mirror_y
+  if (!_init_4G_done) _Init_4G();
+  _setPartialRamArea(x1, y1, w1, h1, mirror_y);
   _writeCommand(0x26);
   for (uint16_t i = 0; i < h1; i++) // lines
   {
@@ -162,7 +164,7 @@ void GxEPD2_290_T94::writeImage_4G(const uint8_t bitmap[], uint8_t bpp, int16_t
       {
         uint8_t in_byte;
         // use wb, h of bitmap for index!
-        uint32_t idx = mirror_y ? j + k + dx / ppb + uint32_t((h - 1 - (i + dy))) * wb : j + k + dx / ppb + uint32_t(i + dy) * wb;
+        uint32_t idx = j + k + dx / ppb + uint32_t(i + sy) * wb;
         if (pgm)
         {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -200,7 +202,7 @@ void GxEPD2_290_T94::writeImage_4G(const uint8_t bitmap[], uint8_t bpp, int16_t
       {
         uint8_t in_byte;
         // use wb, h of bitmap for index!
-        uint32_t idx = mirror_y ? j + k + dx / ppb + uint32_t((h - 1 - (i + dy))) * wb : j + k + dx / ppb + uint32_t(i + dy) * wb;
+        uint32_t idx = j + k + dx / ppb + uint32_t(i + sy) * wb;
         if (pgm)
         {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -267,9 +269,10 @@ void GxEPD2_290_T94::_writeImagePart(uint8_t command, const uint8_t bitmap[], in
   w1 -= dx;
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
+  int16_t sy = mirror_y ? h_bitmap - h1 - y_part - dy : y_part + dy; // first source line, lines are written in reverse order if mirror_y
   if (_refresh_mode == grey_refresh) _Force_Init_Full();
   else if (_refresh_mode == full_refresh) _Init_Part();
-  _setPartialRamArea(x1, y1, w1, h1);
+  _setPartialRamArea(x1, y1, w1, h1, mirror_y);
   _writeCommand(command);
   for (uint16_t i = 0; i < h1; i++)
   {
@@ -277,7 +280,7 @@ void GxEPD2_290_T94::_writeImagePart(uint8_t command, const uint8_t bitmap[], in
     {
       uint8_t data;
       // use wb_bitmap, h_bitmap of bitmap for index!
-      int16_t idx = mirror_y ? x_part / 8 + j + dx / 8 + ((h_bitmap - 1 - (y_part + i + dy))) * wb_bitmap : x_part / 8 + j + dx / 8 + (y_part + i + dy) * wb_bitmap;
+      int16_t idx = x_part / 8 + j + dx / 8 + (i + sy) * wb_bitmap;
       if (pgm)
       {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -324,8 +327,9 @@ void GxEPD2_290_T94::writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int1
   w1 -= dx;
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
-  _Init_4G();
-  _setPartialRamArea(x1, y1, w1, h1);
+  int16_t sy = mirror_y ? h_bitmap - h1 - y_part - dy : y_part + dy; // first source line, lines are written in reverse order if mirror_y
+  if (!_init_4G_done) _Init_4G();
+  _setPartialRamArea(x1, y1, w1, h1, mirror_y);
   _writeCommand(0x26);
   for (uint16_t i = 0; i < h1; i++) // lines
   {
@@ -336,7 +340,7 @@ void GxEPD2_290_T94::writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int1
       {
         uint8_t in_byte;
         // use wb_bitmap, h_bitmap of bitmap for index!
-        uint32_t idx = mirror_y ? x_part / ppb + j + k + dx / ppb + uint32_t((h_bitmap - 1 - (y_part + i + dy))) * wb_bitmap : x_part / ppb + j + k + dx / ppb + uint32_t(y_part + i + dy) * wb_bitmap;
+        uint32_t idx = x_part / ppb + j + k + dx / ppb + uint32_t(i + sy) * wb_bitmap;
         if (pgm)
         {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -374,7 +378,7 @@ void GxEPD2_290_T94::writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int1
       {
         uint8_t in_byte;
         // use wb_bitmap, h_bitmap of bitmap for index!
-        uint32_t idx = mirror_y ? x_part / ppb + j + k + dx / ppb + uint32_t((h_bitmap - 1 - (y_part + i + dy))) * wb_bitmap : x_part / ppb + j + k + dx / ppb + uint32_t(y_part + i + dy) * wb_bitmap;
+        uint32_t idx = x_part / ppb + j + k + dx / ppb + uint32_t(i + sy) * wb_bitmap;
         if (pgm)
         {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -405,6 +409,74 @@ void GxEPD2_290_T94::writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int1
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
 
+void GxEPD2_290_T94::writeNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                        int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+  if ((w_bitmap < 0) || (h_bitmap < 0) || (w < 0) || (h < 0)) return;
+  if ((x_part < 0) || (x_part >= w_bitmap)) return;
+  if ((y_part < 0) || (y_part >= h_bitmap)) return;
+  int16_t wb_bitmap = (w_bitmap + 7) / 8; // width bytes, bitmaps are padded
+  x_part -= x_part % 8; // byte boundary
+  w = w_bitmap - x_part < w ? w_bitmap - x_part : w; // limit
+  h = h_bitmap - y_part < h ? h_bitmap - y_part : h; // limit
+  x -= x % 8; // byte boundary
+  w = 8 * ((w + 7) / 8); // byte boundary, bitmaps are padded
+  int16_t x1 = x < 0 ? 0 : x; // limit
+  int16_t y1 = y < 0 ? 0 : y; // limit
+  uint16_t w1 = x + w < int16_t(WIDTH) ? w : int16_t(WIDTH) - x; // limit
+  uint16_t h1 = y + h < int16_t(HEIGHT) ? h : int16_t(HEIGHT) - y; // limit
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if ((w1 <= 0) || (h1 <= 0)) return;
+  if (!_init_4G_done) _Init_4G();
+  _setPartialRamArea(x1, y1, w1, h1);
+  _writeCommand(0x26); // controller memory holds the inverted planes, as written by writeImage_4G()
+  _startTransfer();
+  for (uint16_t i = 0; i < h1; i++) // lines
+  {
+    const uint8_t* line = plane1 + x_part / 8 + dx / 8 + uint32_t(y_part + i + dy) * wb_bitmap;
+    for (uint16_t j = 0; j < w1 / 8; j++) _transfer(~line[j]);
+  }
+  _endTransfer();
+  _writeCommand(0x24);
+  _startTransfer();
+  for (uint16_t i = 0; i < h1; i++) // lines
+  {
+    const uint8_t* line = plane2 + x_part / 8 + dx / 8 + uint32_t(y_part + i + dy) * wb_bitmap;
+    for (uint16_t j = 0; j < w1 / 8; j++) _transfer(~line[j]);
+  }
+  _endTransfer();
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+}
+
+bool GxEPD2_290_T94::readNativePart_4G(uint8_t* plane1, uint8_t* plane2, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  if (!_canRead()) return false;
+  if ((x % 8) || (w % 8) || (w <= 0) || (h <= 0)) return false;
+  if ((x < 0) || (y < 0) || (x + w > int16_t(WIDTH)) || (y + h > int16_t(HEIGHT))) return false;
+  uint16_t n = (w / 8) * h;
+  _setPartialRamArea(x, y, w, h);
+  _writeCommand(0x41); // read RAM option
+  _writeData(0x01);    // RED RAM (0x26)
+  _writeCommand(0x27); // read RAM, first byte is dummy
+  _readData(plane1, n, 1);
+  _setPartialRamArea(x, y, w, h); // address counter back to start
+  _writeCommand(0x41); // read RAM option
+  _writeData(0x00);    // BW RAM (0x24)
+  _writeCommand(0x27); // read RAM, first byte is dummy
+  _readData(plane2, n, 1);
+  for (uint16_t i = 0; i < n; i++) // back to the plane polarity of writeNativePart_4G()
+  {
+    plane1[i] = ~plane1[i];
+    plane2[i] = ~plane2[i];
+  }
+  return true;
+}
+
 void GxEPD2_290_T94::writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   if (black)
@@ -513,9 +585,14 @@ void GxEPD2_290_T94::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
   if (w1 % 8 > 0) w1 += 8 - w1 % 8;
   x1 -= x1 % 8;
   if (_refresh_mode == full_refresh) _Init_Part();
+  if (_refresh_mode == grey_refresh) // full screen, no area limited update
+  {
+    if (_useFastGrey(w1, h1)) _Update_4G_Fast();
+    else _Update_4G();
+    return;
+  }
   _setPartialRamArea(x1, y1, w1, h1);
-  if (_refresh_mode == grey_refresh) _Update_4G();
-  else _Update_Part();
+  _Update_Part();
 }
 
 void GxEPD2_290_T94::powerOff()
@@ -531,26 +608,46 @@ void GxEPD2_290_T94::hibernate()
     _writeCommand(0x10); // deep sleep mode
     _writeData(0x1);     // enter deep sleep
     _hibernating = true;
+    _init_4G_done = false;
   }
 }
 
-void GxEPD2_290_T94::_setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+void GxEPD2_290_T94::_setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h, bool mirror_y)
 {
   _writeCommand(0x11); // set ram entry mode
-  _writeData(0x03);    // x increase, y increase : normal mode
+  _writeData(mirror_y ? 0x01 : 0x03); // x increase, y increase : normal mode; y decrease if mirror_y
   _writeCommand(0x44);
   _writeData(x / 8);
   _writeData((x + w - 1) / 8);
+  uint16_t ys = mirror_y ? y + h - 1 : y; // first line written
+  uint16_t ye = mirror_y ? y : y + h - 1;
   _writeCommand(0x45);
-  _writeData(y % 256);
-  _writeData(y / 256);
-  _writeData((y + h - 1) % 256);
-  _writeData((y + h - 1) / 256);
+  _writeData(ys % 256);
+  _writeData(ys / 256);
+  _writeData(ye % 256);
+  _writeData(ye / 256);
   _writeCommand(0x4e);
   _writeData(x / 8);
   _writeCommand(0x4f);
-  _writeData(y % 256);
-  _writeData(y / 256);
+  _writeData(ys % 256);
+  _writeData(ys / 256);
+}
+
+bool GxEPD2_290_T94::_readTemperature(int16_t& celsius)
+{
+  if (!_canRead()) return false;
+  uint8_t value[2];
+  _writeCommand(0x18); // use the internal temperature sensor
+  _writeData(0x80);
+  _writeCommand(0x22);
+  _writeData(0xB1); // enable clock, load temperature, load LUT, disable clock
+  _writeCommand(0x20);
+  _waitWhileBusy("_readTemperature", 10);
+  _invalidateLuts(); // LUT register reloaded from OTP
+  _writeCommand(0x1B); // read temperature register
+  _readData(value, 2);
+  celsius = int8_t(value[0]); // A[11:4] integer part, A[3:0] 1/16 degree
+  return true;
 }
 
 void GxEPD2_290_T94::_PowerOn()
@@ -583,6 +680,7 @@ void GxEPD2_290_T94::_InitDisplay()
   if (_hibernating) _reset();
   delay(10); // 10ms according to specs
   _writeCommand(0x12);  //SWRESET
+  _invalidateLuts(); // SWRESET reloads default LUT
   delay(10); // 10ms according to specs
   _writeCommand(0x01); //Driver output control
   _writeData(0x27);
@@ -598,6 +696,7 @@ void GxEPD2_290_T94::_InitDisplay()
   _writeCommand(0x18); //Read built-in temperature sensor
   _writeData(0x80);
   _setPartialRamArea(0, 0, WIDTH, HEIGHT);
+  _init_4G_done = false;
 }
 
 // full screen update LUT 0~3 gray
@@ -624,6 +723,48 @@ const unsigned char GxEPD2_290_T94::lut_4G[] PROGMEM =
   0x22, 0x17, 0x41, 0x0,  0x32, 0x1C
 };
 
+// fast full screen update LUT 0~3 gray, derived from lut_4G without the initial clearing phase, see setFastGreyRefresh()
+// all pixels are driven from RAM content, starting from the level they show; faster and less flashing, but levels are
+// approximate and ghosting adds up; the full grey refresh after the budget restores all levels
+// refresh time can be checked with example GxEPD2_4G_FastGreyCheck
+const unsigned char GxEPD2_290_T94::lut_4G_fast[] PROGMEM =
+{
+  0x48, 0x80, 0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x48, 0x10, 0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x48, 0x4,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x48, 0x1,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x14, 0x1,  0x0,  0x14, 0x1,  0x0,  0x0,
+  0xA,  0x3,  0x0,  0x8,  0x19, 0x0,  0x0,
+  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,  0x0,
+  0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x0,  0x0,  0x0,
+  0x22, 0x17, 0x41, 0x0,  0x32, 0x1C
+};
+
+void GxEPD2_290_T94::_writeLuts_4G(const unsigned char* lut)
+{
+  if (_lutLoaded(0x32, lut)) return; // voltages are loaded together with the LUT, same for both tables
+  _writeCommand(0x32);
+  _writeDataPGM(lut, 153);
+  _writeCommand(0x3F); //EOPQ
+  _writeDataPGM(lut + 153, 1);
+  _writeCommand(0x03); //VGH
+  _writeDataPGM(lut + 154, 1);
+  _writeCommand(0x04); //VSH1, VSH2, VSL
+  _writeDataPGM(lut + 155, 3);
+  _writeCommand(0x2C); //VCOM Voltage
+  _writeDataPGM(lut + 158, 1);
+}
+
 void GxEPD2_290_T94::_Force_Init_Full()
 {
   _Init_Full();
@@ -643,6 +784,7 @@ void GxEPD2_290_T94::_Init_4G()
   if (_hibernating) _reset();
   delay(10); // 10ms according to specs
   _writeCommand(0x12); // soft reset
+  _invalidateLuts(); // SWRESET reloads default LUT
   //delay(10); // 10ms according to specs
   _waitWhileBusy("_Init_4G", full_refresh_time);
   _writeCommand(0x74); //set analog block control
@@ -656,22 +798,12 @@ void GxEPD2_290_T94::_Init_4G()
   _setPartialRamArea(0, 0, WIDTH, HEIGHT);
   _writeCommand(0x3C); //BorderWavefrom
   _writeData(0x00);
-  _writeCommand(0x2C);     //VCOM Voltage
-  _writeData(0x1C); //LUT_DATA_4Gray[158]);    //0x1C
-  _writeCommand(0x3F); //EOPQ
-  _writeData(0x22); //LUT_DATA_4Gray[153]);
-  _writeCommand(0x03); //VGH
-  _writeData(0x17); //LUT_DATA_4Gray[154]);
-  _writeCommand(0x04); //
-  _writeData(0x41); //LUT_DATA_4Gray[155]); //VSH1
-  _writeData(0x0); //LUT_DATA_4Gray[156]); //VSH2
-  _writeData(0x32); //LUT_DATA_4Gray[157]); //VSL
   _writeCommand(0x21); //  Display update control
   _writeData(0x00);
   _writeData(0x80);
-  _writeCommand(0x32);
-  _writeDataPGM(lut_4G, 153);
+  _writeLuts_4G(lut_4G);
   _PowerOn();
+  _init_4G_done = true;
   _refresh_mode = grey_refresh;
 }
 
@@ -692,10 +824,23 @@ void GxEPD2_290_T94::_Update_Full()
 
 void GxEPD2_290_T94::_Update_4G()
 {
+  _writeLuts_4G(lut_4G); // skipped if still loaded, reloaded from OTP by _readTemperature()
+  _PowerOn();
   _writeCommand(0x22);
   _writeData(0xc4);
   _writeCommand(0x20);
   _waitWhileBusy("_Update_4G", full_refresh_time);
+  _fast_grey_count = 0;
+}
+
+void GxEPD2_290_T94::_Update_4G_Fast()
+{
+  _writeLuts_4G(lut_4G_fast);
+  _PowerOn();
+  _writeCommand(0x22);
+  _writeData(0xc4);
+  _writeCommand(0x20);
+  _waitWhileBusy("_Update_4G_Fast", grey_fast_refresh_time);
 }
 
 void GxEPD2_290_T94::_Update_Part()
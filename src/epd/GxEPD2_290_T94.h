@@ -27,10 +27,14 @@ class GxEPD2_290_T94 : public GxEPD2_4G_EPD
     static const bool hasPartialUpdate = false; // with grey refresh
     //static const bool hasFastPartialUpdate = false; // with grey refresh
     static const bool hasFastPartialUpdate = true; // with b/w refresh
+    static const bool hasPartialUpdateWindow_4G = false; // grey partial refresh drives full screen (SSD16xx)
     static const uint16_t power_on_time = 100; // ms, e.g. 95868us
     static const uint16_t power_off_time = 150; // ms, e.g. 140350us
     static const uint16_t full_refresh_time = 5500; // ms, e.g. 5406814us
     static const uint16_t partial_refresh_time = 500; // ms, e.g. 458231us
+    // refresh(x, y, w, h) in grey mode refreshes the full screen, SSD1680 has no area limited update; within the budget
+    // of setFastGreyRefresh() it uses the fast grey LUT without clearing phase, else the full grey LUT
+    static const uint16_t grey_fast_refresh_time = 2000; // ms, estimate: 88 of 262 LUT frames of full_refresh_time, ~1820ms, with margin
     // constructor
     GxEPD2_290_T94(int16_t cs, int16_t dc, int16_t rst, int16_t busy);
     // methods (virtual)
@@ -46,6 +50,11 @@ class GxEPD2_290_T94 : public GxEPD2_4G_EPD
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+    // write two 1bpp planes, native format of 4 grey level write, see GxEPD2_4G_EPD
+    void writeNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                            int16_t x, int16_t y, int16_t w, int16_t h);
+    // read two 1bpp planes back from controller memory (0x27), needs setReadPins(); x and w must be multiple of 8
+    bool readNativePart_4G(uint8_t* plane1, uint8_t* plane2, int16_t x, int16_t y, int16_t w, int16_t h);
     void writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void writeImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
@@ -77,7 +86,8 @@ class GxEPD2_290_T94 : public GxEPD2_4G_EPD
     void _writeImage(uint8_t command, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void _writeImagePart(uint8_t command, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                          int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
-    void _setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void _setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h, bool mirror_y = false);
+    bool _readTemperature(int16_t& celsius);
     void _PowerOn();
     void _PowerOff();
     void _InitDisplay();
@@ -87,10 +97,21 @@ class GxEPD2_290_T94 : public GxEPD2_4G_EPD
     void _Init_Part();
     void _Update_Full();
     void _Update_4G();
+    void _Update_4G_Fast();
+    void _writeLuts_4G(const unsigned char* lut); // lut_4G or lut_4G_fast, with the voltages
     void _Update_Part();
+    uint8_t _saveDriverState()
+    {
+      return _refresh_mode;
+    };
+    void _restoreDriverState(uint8_t state)
+    {
+      _refresh_mode = decltype(_refresh_mode)(state);
+    };
   private:
     enum {full_refresh, grey_refresh, fast_refresh, forced_full_refresh} _refresh_mode;
     static const unsigned char lut_4G[];
+    static const unsigned char lut_4G_fast[];
 };
 
 #endif
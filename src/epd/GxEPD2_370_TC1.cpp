@@ -15,7 +15,7 @@
 #include "GxEPD2_370_TC1.h"
 
 GxEPD2_370_TC1::GxEPD2_370_TC1(int16_t cs, int16_t dc, int16_t rst, int16_t busy) :
-  GxEPD2_4G_EPD(cs, dc, rst, busy, HIGH, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate)
+  GxEPD2_4G_EPD(cs, dc, rst, busy, HIGH, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate, hasPartialUpdateWindow_4G)
 {
   _refresh_mode = unset_refresh;
 }
@@ -126,9 +126,10 @@ void GxEPD2_370_TC1::_writeImage(uint8_t command, const uint8_t bitmap[], int16_
   w1 -= dx;
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
+  int16_t sy = mirror_y ? h - h1 - dy : dy; // first source line, lines are written in reverse order if mirror_y
   if (!_init_display_done) _InitDisplay();
   if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
-  _setPartialRamArea(x1, y1, w1, h1);
+  _setPartialRamArea(x1, y1, w1, h1, mirror_y);
   _writeCommand(command);
   _startTransfer();
   for (int16_t i = 0; i < h1; i++)
@@ -137,7 +138,7 @@ void GxEPD2_370_TC1::_writeImage(uint8_t command, const uint8_t bitmap[], int16_
     {
       uint8_t data;
       // use wb, h of bitmap for index!
-      int32_t idx = mirror_y ? j + dx / 8 + ((h - 1 - (i + dy))) * wb : j + dx / 8 + (i + dy) * wb;
+      int32_t idx = j + dx / 8 + (i + sy) * wb;
       if (pgm)
       {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -179,8 +180,9 @@ void GxEPD2_370_TC1::writeImage_4G(const uint8_t bitmap[], uint8_t bpp, int16_t
   w1 -= dx;
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
+  int16_t sy = mirror_y ? h - h1 - dy : dy; // first source line, lines are written in reverse order if mirror_y
   if (!_init_4G_done) _Init_4G();
-  _setPartialRamArea(x1, y1, w1, h1);
+  _setPartialRamArea(x1, y1, w1, h1, mirror_y);
   _writeCommand(0x26);
   _startTransfer();
   for (uint16_t i = 0; i < h1; i++) // lines
@@ -192,7 +194,7 @@ void GxEPD2_370_TC1::writeImage_4G(const uint8_t bitmap[], uint8_t bpp, int16_t
       {
         uint8_t in_byte;
         // use wb, h of bitmap for index!
-        uint32_t idx = mirror_y ? j + k + dx / ppb + uint32_t((h - 1 - (i + dy))) * wb : j + k + dx / ppb + uint32_t(i + dy) * wb;
+        uint32_t idx = j + k + dx / ppb + uint32_t(i + sy) * wb;
         if (pgm)
         {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -232,7 +234,7 @@ void GxEPD2_370_TC1::writeImage_4G(const uint8_t bitmap[], uint8_t bpp, int16_t
       {
         uint8_t in_byte;
         // use wb, h of bitmap for index!
-        uint32_t idx = mirror_y ? j + k + dx / ppb + uint32_t((h - 1 - (i + dy))) * wb : j + k + dx / ppb + uint32_t(i + dy) * wb;
+        uint32_t idx = j + k + dx / ppb + uint32_t(i + sy) * wb;
         if (pgm)
         {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -309,10 +311,11 @@ void GxEPD2_370_TC1::_writeImagePart(uint8_t command, const uint8_t bitmap[], in
   w1 -= dx;
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
+  int16_t sy = mirror_y ? h_bitmap - h1 - y_part - dy : y_part + dy; // first source line, lines are written in reverse order if mirror_y
   if (!_init_display_done) _InitDisplay();
   if (_refresh_mode == full_refresh) _Init_Part();
   if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
-  _setPartialRamArea(x1, y1, w1, h1);
+  _setPartialRamArea(x1, y1, w1, h1, mirror_y);
   _writeCommand(command);
   _startTransfer();
   for (int16_t i = 0; i < h1; i++)
@@ -321,7 +324,7 @@ void GxEPD2_370_TC1::_writeImagePart(uint8_t command, const uint8_t bitmap[], in
     {
       uint8_t data;
       // use wb_bitmap, h_bitmap of bitmap for index!
-      int32_t idx = mirror_y ? x_part / 8 + j + dx / 8 + ((h_bitmap - 1 - (y_part + i + dy))) * wb_bitmap : x_part / 8 + j + dx / 8 + (y_part + i + dy) * wb_bitmap;
+      int32_t idx = x_part / 8 + j + dx / 8 + (i + sy) * wb_bitmap;
       if (pgm)
       {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -368,8 +371,9 @@ void GxEPD2_370_TC1::writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int1
   w1 -= dx;
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
+  int16_t sy = mirror_y ? h_bitmap - h1 - y_part - dy : y_part + dy; // first source line, lines are written in reverse order if mirror_y
   if (!_init_4G_done) _Init_4G();
-  _setPartialRamArea(x1, y1, w1, h1);
+  _setPartialRamArea(x1, y1, w1, h1, mirror_y);
   _writeCommand(0x26);
   _startTransfer();
   for (uint16_t i = 0; i < h1; i++) // lines
@@ -381,7 +385,7 @@ void GxEPD2_370_TC1::writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int1
       {
         uint8_t in_byte;
         // use wb_bitmap, h_bitmap of bitmap for index!
-        uint32_t idx = mirror_y ? x_part / ppb + j + k + dx / ppb + uint32_t((h_bitmap - 1 - (y_part + i + dy))) * wb_bitmap : x_part / ppb + j + k + dx / ppb + uint32_t(y_part + i + dy) * wb_bitmap;
+        uint32_t idx = x_part / ppb + j + k + dx / ppb + uint32_t(i + sy) * wb_bitmap;
         if (pgm)
         {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -421,7 +425,7 @@ void GxEPD2_370_TC1::writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int1
       {
         uint8_t in_byte;
         // use wb_bitmap, h_bitmap of bitmap for index!
-        uint32_t idx = mirror_y ? x_part / ppb + j + k + dx / ppb + uint32_t((h_bitmap - 1 - (y_part + i + dy))) * wb_bitmap : x_part / ppb + j + k + dx / ppb + uint32_t(y_part + i + dy) * wb_bitmap;
+        uint32_t idx = x_part / ppb + j + k + dx / ppb + uint32_t(i + sy) * wb_bitmap;
         if (pgm)
         {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -453,6 +457,73 @@ void GxEPD2_370_TC1::writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int1
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
 
+void GxEPD2_370_TC1::writeNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                        int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+  if ((w_bitmap < 0) || (h_bitmap < 0) || (w < 0) || (h < 0)) return;
+  if ((x_part < 0) || (x_part >= w_bitmap)) return;
+  if ((y_part < 0) || (y_part >= h_bitmap)) return;
+  int16_t wb_bitmap = (w_bitmap + 7) / 8; // width bytes, bitmaps are padded
+  x_part -= x_part % 8; // byte boundary
+  w = w_bitmap - x_part < w ? w_bitmap - x_part : w; // limit
+  h = h_bitmap - y_part < h ? h_bitmap - y_part : h; // limit
+  x -= x % 8; // byte boundary
+  w = 8 * ((w + 7) / 8); // byte boundary, bitmaps are padded
+  int16_t x1 = x < 0 ? 0 : x; // limit
+  int16_t y1 = y < 0 ? 0 : y; // limit
+  uint16_t w1 = x + w < int16_t(WIDTH) ? w : int16_t(WIDTH) - x; // limit
+  uint16_t h1 = y + h < int16_t(HEIGHT) ? h : int16_t(HEIGHT) - y; // limit
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if ((w1 <= 0) || (h1 <= 0)) return;
+  if (!_init_4G_done) _Init_4G();
+  _setPartialRamArea(x1, y1, w1, h1);
+  _writeCommand(0x26); // controller memory holds the inverted planes, as written by writeImage_4G()
+  _startTransfer();
+  for (uint16_t i = 0; i < h1; i++) // lines
+  {
+    const uint8_t* line = plane1 + x_part / 8 + dx / 8 + uint32_t(y_part + i + dy) * wb_bitmap;
+    for (uint16_t j = 0; j < w1 / 8; j++) _transfer(~line[j]);
+  }
+  _endTransfer();
+  _writeCommand(0x24);
+  _startTransfer();
+  for (uint16_t i = 0; i < h1; i++) // lines
+  {
+    const uint8_t* line = plane2 + x_part / 8 + dx / 8 + uint32_t(y_part + i + dy) * wb_bitmap;
+    for (uint16_t j = 0; j < w1 / 8; j++) _transfer(~line[j]);
+  }
+  _endTransfer();
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+}
+
+bool GxEPD2_370_TC1::readNativePart_4G(uint8_t* plane1, uint8_t* plane2, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  if (!_canRead()) return false;
+  if ((x % 8) || (w % 8) || (w <= 0) || (h <= 0)) return false;
+  if ((x < 0) || (y < 0) || (x + w > int16_t(WIDTH)) || (y + h > int16_t(HEIGHT))) return false;
+  uint16_t n = (w / 8) * h;
+  _setPartialRamArea(x, y, w, h);
+  _writeCommand(0x41); // read RAM option
+  _writeData(0x01);    // RED RAM (0x26)
+  _writeCommand(0x27); // read RAM, first byte is dummy
+  _readData(plane1, n, 1);
+  _setPartialRamArea(x, y, w, h); // address counter back to start
+  _writeCommand(0x41); // read RAM option
+  _writeData(0x00);    // BW RAM (0x24)
+  _writeCommand(0x27); // read RAM, first byte is dummy
+  _readData(plane2, n, 1);
+  for (uint16_t i = 0; i < n; i++) // back to the plane polarity of writeNativePart_4G()
+  {
+    plane1[i] = ~plane1[i];
+    plane2[i] = ~plane2[i];
+  }
+  return true;
+}
+
 void GxEPD2_370_TC1::writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   if (black)
@@ -589,26 +660,45 @@ void GxEPD2_370_TC1::hibernate()
   }
 }
 
-void GxEPD2_370_TC1::_setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+void GxEPD2_370_TC1::_setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h, bool mirror_y)
 {
   _writeCommand(0x11); // set ram entry mode
-  _writeData(0x03);    // x increase, y increase : normal mode
+  _writeData(mirror_y ? 0x01 : 0x03); // x increase, y increase : normal mode; y decrease if mirror_y
   _writeCommand(0x44);
   _writeData(x % 256);
   _writeData(x / 256);
   _writeData((x + w - 1) % 256);
   _writeData((x + w - 1) / 256);
+  uint16_t ys = mirror_y ? y + h - 1 : y; // first line written
+  uint16_t ye = mirror_y ? y : y + h - 1;
   _writeCommand(0x45);
-  _writeData(y % 256);
-  _writeData(y / 256);
-  _writeData((y + h - 1) % 256);
-  _writeData((y + h - 1) / 256);
+  _writeData(ys % 256);
+  _writeData(ys / 256);
+  _writeData(ye % 256);
+  _writeData(ye / 256);
   _writeCommand(0x4e);
   _writeData(x % 256);
   _writeData(x / 256);
   _writeCommand(0x4f);
-  _writeData(y % 256);
-  _writeData(y / 256);
+  _writeData(ys % 256);
+  _writeData(ys / 256);
+}
+
+bool GxEPD2_370_TC1::_readTemperature(int16_t& celsius)
+{
+  if (!_canRead()) return false;
+  uint8_t value[2];
+  _writeCommand(0x18); // use the internal temperature sensor
+  _writeData(0x80);
+  _writeCommand(0x22);
+  _writeData(0xB1); // enable clock, load temperature, load LUT, disable clock
+  _writeCommand(0x20);
+  _waitWhileBusy("_readTemperature", 10);
+  _invalidateLuts(); // LUT register reloaded from OTP
+  _writeCommand(0x1B); // read temperature register
+  _readData(value, 2);
+  celsius = int8_t(value[0]); // A[11:4] integer part, A[3:0] 1/16 degree
+  return true;
 }
 
 void GxEPD2_370_TC1::_PowerOn()
@@ -640,6 +730,7 @@ void GxEPD2_370_TC1::_InitDisplay()
   if (_hibernating)  _reset();
   delay(10); // 10ms according to specs
   _writeCommand(0x12);  //SWRESET
+  _invalidateLuts(); // SWRESET reloads default LUT
   delay(10); // 10ms according to specs
   //_writeCommand(0x46); // Auto Write RED RAM **DON'T USE WITH GxEPD2**
   //_writeData(0xF7);
@@ -727,6 +818,21 @@ const unsigned char GxEPD2_370_TC1::lut_4G[] PROGMEM =
   0x22, 0x22, 0x22, 0x22, 0x22
 };
 
+void GxEPD2_370_TC1::_writeLuts_4G()
+{
+  if (_lutLoaded(0x32, lut_4G)) return; // voltages are loaded together with the LUT
+  _writeCommand(0x32);
+  _writeDataPGM(lut_4G, 105);
+  _writeCommand(0x03); // set gate voltage
+  _writeData(0x00);
+  _writeCommand(0x04); // set source voltage
+  _writeData(0x41);
+  _writeData(0xA8);
+  _writeData(0x32);
+  _writeCommand(0x2C); // set vcom value
+  _writeData(0x44);
+}
+
 void GxEPD2_370_TC1::_Force_Init_Full()
 {
   _InitDisplay();
@@ -738,8 +844,7 @@ void GxEPD2_370_TC1::_Init_Full()
 {
   _writeCommand(0x3C); // Border Waveform Control
   _writeData(0x01); // LUT1, for white
-  _writeCommand(0x32);
-  _writeDataPGM(lut_full, sizeof(lut_full));
+  _writeLutPGM(0x32, lut_full, sizeof(lut_full));
   _refresh_mode = full_refresh;
 }
 
@@ -748,6 +853,7 @@ void GxEPD2_370_TC1::_Init_4G()
   if (_hibernating) _reset();
   delay(10); // 10ms according to specs
   _writeCommand(0x12);
+  _invalidateLuts(); // SWRESET reloads default LUT
   //_waitWhileBusy("_Init_4G 1", power_on_time); // 1ms
   delay(2);
   _writeCommand(0x46);
@@ -762,12 +868,6 @@ void GxEPD2_370_TC1::_Init_4G()
   _writeData(0xDF);
   _writeData(0x01);
   _writeData(0x00);
-  _writeCommand(0x03); // set gate voltage
-  _writeData(0x00);
-  _writeCommand(0x04); // set source voltage
-  _writeData(0x41);
-  _writeData(0xA8);
-  _writeData(0x32);
   _writeCommand(0x11); // set data entry sequence
   _writeData(0x03);
   _writeCommand(0x3C); // set border
@@ -780,8 +880,6 @@ void GxEPD2_370_TC1::_Init_4G()
   _writeData(0xC0);
   _writeCommand(0x18); // set internal sensor on
   _writeData(0x80);
-  _writeCommand(0x2C); // set vcom value
-  _writeData(0x44);
   _writeCommand(0x44); // setting X direction start/end position of RAM
   _writeData(0x00);
   _writeData(0x00);
@@ -797,8 +895,7 @@ void GxEPD2_370_TC1::_Init_4G()
   _writeCommand(0x21); // Display Update Controll
   _writeData(0x88);    // BW and RED inversed
   _writeData(0x00);    // single chip application
-  _writeCommand(0x32);
-  _writeDataPGM(lut_4G, 105);
+  _writeLuts_4G();
   _writeScreenBuffer(0x24, 0x00); // set current
   _writeScreenBuffer(0x26, 0x00); // set previous
   _initial_write = false;
@@ -811,8 +908,7 @@ void GxEPD2_370_TC1::_Init_Part()
 {
   _writeCommand(0x3C); // Border Waveform Control
   _writeData(0xC0);    // HiZ, [POR], floating
-  _writeCommand(0x32);
-  _writeDataPGM(lut_partial, sizeof(lut_partial));
+  _writeLutPGM(0x32, lut_partial, sizeof(lut_partial));
   _refresh_mode = fast_refresh;
 }
 
@@ -827,6 +923,7 @@ void GxEPD2_370_TC1::_Update_Full()
 
 void GxEPD2_370_TC1::_Update_4G()
 {
+  _writeLuts_4G(); // skipped if still loaded, reloaded from OTP by _readTemperature()
   _writeCommand(0x22);
   _writeData(0xc7);
   _writeCommand(0x20);
@@ -13,7 +13,7 @@
 #include "GxEPD2_420.h"
 
 GxEPD2_420::GxEPD2_420(int16_t cs, int16_t dc, int16_t rst, int16_t busy) :
-  GxEPD2_4G_EPD(cs, dc, rst, busy, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate)
+  GxEPD2_4G_EPD(cs, dc, rst, busy, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate, hasPartialUpdateWindow_4G)
 {
   _refresh_mode = full_refresh;
 }
@@ -362,6 +362,53 @@ void GxEPD2_420::writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int16_t
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
 
+void GxEPD2_420::writeNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                    int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+  if ((w_bitmap < 0) || (h_bitmap < 0) || (w < 0) || (h < 0)) return;
+  if ((x_part < 0) || (x_part >= w_bitmap)) return;
+  if ((y_part < 0) || (y_part >= h_bitmap)) return;
+  int16_t wb_bitmap = (w_bitmap + 7) / 8; // width bytes, bitmaps are padded
+  x_part -= x_part % 8; // byte boundary
+  w = w_bitmap - x_part < w ? w_bitmap - x_part : w; // limit
+  h = h_bitmap - y_part < h ? h_bitmap - y_part : h; // limit
+  int16_t wbc = (w + 7) / 8; // width bytes on controller
+  x -= x % 8; // byte boundary on controller
+  w = wbc * 8; // byte boundary on controller
+  int16_t x1 = x < 0 ? 0 : x; // limit
+  int16_t y1 = y < 0 ? 0 : y; // limit
+  uint16_t w1 = x + w < int16_t(WIDTH) ? w : int16_t(WIDTH) - x; // limit
+  uint16_t h1 = y + h < int16_t(HEIGHT) ? h : int16_t(HEIGHT) - y; // limit
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if ((w1 <= 0) || (h1 <= 0)) return;
+  _Init_4G();
+  _writeCommand(0x91); // partial in
+  _setPartialRamArea(x1, y1, w1, h1);
+  _writeCommand(0x10);
+  _startTransfer();
+  for (uint16_t i = 0; i < h1; i++) // lines
+  {
+    const uint8_t* line = plane1 + x_part / 8 + dx / 8 + uint32_t(y_part + i + dy) * wb_bitmap;
+    for (uint16_t j = 0; j < w1 / 8; j++) _transfer(line[j]);
+  }
+  _endTransfer();
+  _writeCommand(0x13);
+  _startTransfer();
+  for (uint16_t i = 0; i < h1; i++) // lines
+  {
+    const uint8_t* line = plane2 + x_part / 8 + dx / 8 + uint32_t(y_part + i + dy) * wb_bitmap;
+    for (uint16_t j = 0; j < w1 / 8; j++) _transfer(line[j]);
+  }
+  _endTransfer();
+  _writeCommand(0x92); // partial out
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+}
+
 void GxEPD2_420::writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   if (black)
@@ -470,7 +517,8 @@ void GxEPD2_420::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
   if (usePartialUpdateWindow) _writeCommand(0x91); // partial in
   //else if (_refresh_mode == grey_refresh) _writeCommand(0x91); // doesn't work correctly
   _setPartialRamArea(x1, y1, w1, h1);
-  if (_refresh_mode == grey_refresh) _Update_4G();
+  if ((_refresh_mode == grey_refresh) && _useFastGrey(w1, h1)) _Update_4G_Fast();
+  else if (_refresh_mode == grey_refresh) _Update_4G();
   else _Update_Part();
   if (usePartialUpdateWindow) _writeCommand(0x92); // partial out
   //else if (_refresh_mode == grey_refresh) _writeCommand(0x92); // doesn't work correctly
@@ -492,6 +540,13 @@ void GxEPD2_420::hibernate()
   }
 }
 
+bool GxEPD2_420::setLutSet(LutMode mode, const LutSet* lut_set)
+{
+  if (mode > lut_grey_fast) return false;
+  _lut_sets[mode] = lut_set;
+  return true;
+}
+
 void GxEPD2_420::_setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 {
   uint16_t xe = (x + w - 1) | 0x0007; // byte boundary inclusive (last byte)
@@ -725,6 +780,85 @@ const unsigned char GxEPD2_420::lut_24_bb_partial[] PROGMEM =
   0x00,  1,  0,  0,  0, 1, // gnd phase
 };
 
+// short grey waveform, last (level) phase of the grey waveform only, no clearing phases
+const unsigned char GxEPD2_420::lut_20_vcom0_4G_fast[] PROGMEM =
+{
+  0x00, 0x13, 0x0A, 0x01, 0x00, 0x01,
+};
+
+const unsigned char GxEPD2_420::lut_21_ww_4G_fast[] PROGMEM =
+{
+  0xA0, 0x13, 0x01, 0x00, 0x00, 0x01,
+};
+
+const unsigned char GxEPD2_420::lut_22_bw_4G_fast[] PROGMEM =
+{
+  0x99, 0x0C, 0x01, 0x03, 0x04, 0x01,
+};
+
+const unsigned char GxEPD2_420::lut_23_wb_4G_fast[] PROGMEM =
+{
+  0x99, 0x0B, 0x04, 0x04, 0x01, 0x01,
+};
+
+const unsigned char GxEPD2_420::lut_24_bb_4G_fast[] PROGMEM =
+{
+  0x50, 0x13, 0x01, 0x00, 0x00, 0x01,
+};
+
+const GxEPD2_4G_EPD::LutTable GxEPD2_420::lut_tables_4G_fast[] =
+{
+  {0x20, lut_20_vcom0_4G_fast, sizeof(lut_20_vcom0_4G_fast), 44},
+  {0x21, lut_21_ww_4G_fast, sizeof(lut_21_ww_4G_fast), 42},
+  {0x22, lut_22_bw_4G_fast, sizeof(lut_22_bw_4G_fast), 42},
+  {0x23, lut_23_wb_4G_fast, sizeof(lut_23_wb_4G_fast), 42},
+  {0x24, lut_24_bb_4G_fast, sizeof(lut_24_bb_4G_fast), 42},
+};
+
+const GxEPD2_4G_EPD::LutSet GxEPD2_420::lut_set_grey_fast = {lut_tables_4G_fast, 5, 400};
+
+// partial update waveform as by demo code from Good Display, faster, no balance and sustain phases
+const unsigned char GxEPD2_420::lut_20_vcom0_partial_fast[] PROGMEM =
+{
+  0x00,  0,  0,  0, 25, 1, // 00 00 00 00
+  0x00,  1,  0,  0,  0, 1, // gnd phase
+};
+
+const unsigned char GxEPD2_420::lut_21_ww_partial_fast[] PROGMEM =
+{ // 10 w
+  0x18,  0,  0,  0, 25, 1, // 00 01 10 00
+  0x00,  1,  0,  0,  0, 1, // gnd phase
+};
+
+const unsigned char GxEPD2_420::lut_22_bw_partial_fast[] PROGMEM =
+{ // 10 w
+  0x5A,  0,  0,  0, 25, 1, // 01 01 10 10
+  0x00,  1,  0,  0,  0, 1, // gnd phase
+};
+
+const unsigned char GxEPD2_420::lut_23_wb_partial_fast[] PROGMEM =
+{ // 01 b
+  0xA5,  0,  0,  0, 25, 1, // 10 10 01 01
+  0x00,  1,  0,  0,  0, 1, // gnd phase
+};
+
+const unsigned char GxEPD2_420::lut_24_bb_partial_fast[] PROGMEM =
+{ // 01 b
+  0x24,  0,  0,  0, 25, 1, // 00 10 01 00
+  0x00,  1,  0,  0,  0, 1, // gnd phase
+};
+
+const GxEPD2_4G_EPD::LutTable GxEPD2_420::lut_tables_partial_fast[] =
+{
+  {0x20, lut_20_vcom0_partial_fast, sizeof(lut_20_vcom0_partial_fast), 44},
+  {0x21, lut_21_ww_partial_fast, sizeof(lut_21_ww_partial_fast), 42},
+  {0x22, lut_22_bw_partial_fast, sizeof(lut_22_bw_partial_fast), 42},
+  {0x23, lut_23_wb_partial_fast, sizeof(lut_23_wb_partial_fast), 42},
+  {0x24, lut_24_bb_partial_fast, sizeof(lut_24_bb_partial_fast), 42},
+};
+
+const GxEPD2_4G_EPD::LutSet GxEPD2_420::lut_set_partial_fast = {lut_tables_partial_fast, 5, 300};
+
 void GxEPD2_420::_Force_Init_Full()
 {
   _Init_Full();
@@ -734,16 +868,15 @@ void GxEPD2_420::_Force_Init_Full()
 void GxEPD2_420::_Init_Full()
 {
   _InitDisplay();
-  _writeCommand(0x20);
-  _writeDataPGM(lut_20_vcom0_full, sizeof(lut_20_vcom0_full));
-  _writeCommand(0x21);
-  _writeDataPGM(lut_21_ww_full, sizeof(lut_21_ww_full));
-  _writeCommand(0x22);
-  _writeDataPGM(lut_22_bw_full, sizeof(lut_22_bw_full));
-  _writeCommand(0x23);
-  _writeDataPGM(lut_23_wb_full, sizeof(lut_23_wb_full));
-  _writeCommand(0x24);
-  _writeDataPGM(lut_24_bb_full, sizeof(lut_24_bb_full));
+  if (_lut_sets[lut_full]) _writeLutSet(*_lut_sets[lut_full]);
+  else
+  {
+    _writeLutPGM(0x20, lut_20_vcom0_full, sizeof(lut_20_vcom0_full));
+    _writeLutPGM(0x21, lut_21_ww_full, sizeof(lut_21_ww_full));
+    _writeLutPGM(0x22, lut_22_bw_full, sizeof(lut_22_bw_full));
+    _writeLutPGM(0x23, lut_23_wb_full, sizeof(lut_23_wb_full));
+    _writeLutPGM(0x24, lut_24_bb_full, sizeof(lut_24_bb_full));
+  }
   _PowerOn();
   _refresh_mode = full_refresh;
 }
@@ -751,34 +884,37 @@ void GxEPD2_420::_Init_Full()
 void GxEPD2_420::_Init_4G()
 {
   _InitDisplay();
-  _writeCommand(0x20);
-  _writeDataPGM(lut_20_vcom0_4G, sizeof(lut_20_vcom0_4G));
-  _writeCommand(0x21);
-  _writeDataPGM(lut_21_ww_4G, sizeof(lut_21_ww_4G));
-  _writeCommand(0x22);
-  _writeDataPGM(lut_22_bw_4G, sizeof(lut_22_bw_4G));
-  _writeCommand(0x23);
-  _writeDataPGM(lut_23_wb_4G, sizeof(lut_23_wb_4G));
-  _writeCommand(0x24);
-  _writeDataPGM(lut_24_bb_4G, sizeof(lut_24_bb_4G));
+  _writeLuts_4G();
   _PowerOn();
   _refresh_mode = grey_refresh;
 }
 
+void GxEPD2_420::_writeLuts_4G()
+{
+  if (_lut_sets[lut_grey]) _writeLutSet(*_lut_sets[lut_grey]);
+  else
+  {
+    _writeLutPGM(0x20, lut_20_vcom0_4G, sizeof(lut_20_vcom0_4G));
+    _writeLutPGM(0x21, lut_21_ww_4G, sizeof(lut_21_ww_4G));
+    _writeLutPGM(0x22, lut_22_bw_4G, sizeof(lut_22_bw_4G));
+    _writeLutPGM(0x23, lut_23_wb_4G, sizeof(lut_23_wb_4G));
+    _writeLutPGM(0x24, lut_24_bb_4G, sizeof(lut_24_bb_4G));
+  }
+}
+
 void GxEPD2_420::_Init_Part()
 {
   Serial.println("_Init_Part");
   _InitDisplay();
-  _writeCommand(0x20);
-  _writeDataPGM(lut_20_vcom0_partial, sizeof(lut_20_vcom0_partial), 44 - sizeof(lut_20_vcom0_partial));
-  _writeCommand(0x21);
-  _writeDataPGM(lut_21_ww_partial, sizeof(lut_21_ww_partial), 42 - sizeof(lut_21_ww_partial));
-  _writeCommand(0x22);
-  _writeDataPGM(lut_22_bw_partial, sizeof(lut_22_bw_partial), 42 - sizeof(lut_22_bw_partial));
-  _writeCommand(0x23);
-  _writeDataPGM(lut_23_wb_partial, sizeof(lut_23_wb_partial), 42 - sizeof(lut_23_wb_partial));
-  _writeCommand(0x24);
-  _writeDataPGM(lut_24_bb_partial, sizeof(lut_24_bb_partial), 42 - sizeof(lut_24_bb_partial));
+  if (_lut_sets[lut_partial]) _writeLutSet(*_lut_sets[lut_partial]);
+  else
+  {
+    _writeLutPGM(0x20, lut_20_vcom0_partial, sizeof(lut_20_vcom0_partial), 44 - sizeof(lut_20_vcom0_partial));
+    _writeLutPGM(0x21, lut_21_ww_partial, sizeof(lut_21_ww_partial), 42 - sizeof(lut_21_ww_partial));
+    _writeLutPGM(0x22, lut_22_bw_partial, sizeof(lut_22_bw_partial), 42 - sizeof(lut_22_bw_partial));
+    _writeLutPGM(0x23, lut_23_wb_partial, sizeof(lut_23_wb_partial), 42 - sizeof(lut_23_wb_partial));
+    _writeLutPGM(0x24, lut_24_bb_partial, sizeof(lut_24_bb_partial), 42 - sizeof(lut_24_bb_partial));
+  }
   _PowerOn();
   _refresh_mode = fast_refresh;
 }
@@ -786,17 +922,27 @@ void GxEPD2_420::_Init_Part()
 void GxEPD2_420::_Update_Full()
 {
   _writeCommand(0x12); //display refresh
-  _waitWhileBusy("_Update_Full", full_refresh_time);
+  _waitWhileBusy("_Update_Full", _lutRefreshTime(lut_full, full_refresh_time));
 }
 
 void GxEPD2_420::_Update_4G()
 {
+  _writeLuts_4G(); // skipped if still loaded, e.g. replaced by _Update_4G_Fast()
+  _writeCommand(0x12); //display refresh
+  _waitWhileBusy("_Update_4G", _lutRefreshTime(lut_grey, full_refresh_time));
+  _fast_grey_count = 0;
+}
+
+void GxEPD2_420::_Update_4G_Fast()
+{
+  const LutSet* lut_set = _lut_sets[lut_grey_fast] ? _lut_sets[lut_grey_fast] : &lut_set_grey_fast;
+  _writeLutSet(*lut_set);
   _writeCommand(0x12); //display refresh
-  _waitWhileBusy("_Update_4G", full_refresh_time);
+  _waitWhileBusy("_Update_4G_Fast", lut_set->refresh_time > 0 ? lut_set->refresh_time : lut_set_grey_fast.refresh_time);
 }
 
 void GxEPD2_420::_Update_Part()
 {
   _writeCommand(0x12); //display refresh
-  _waitWhileBusy("_Update_Part", partial_refresh_time);
+  _waitWhileBusy("_Update_Part", _lutRefreshTime(lut_partial, partial_refresh_time));
 }
@@ -26,6 +26,7 @@ class GxEPD2_420 : public GxEPD2_4G_EPD
     static const bool hasPartialUpdate = true;
     static const bool usePartialUpdateWindow = false; // set false for better image
     static const bool hasFastPartialUpdate = true;
+    static const bool hasPartialUpdateWindow_4G = false; // grey partial window doesn't work correctly
     static const uint16_t power_on_time = 40; // ms, e.g. 36996us
     static const uint16_t power_off_time = 20; // ms, e.g. 19285us
     static const uint16_t full_refresh_time = 1600; // ms, e.g. 1545659us
@@ -43,6 +44,9 @@ class GxEPD2_420 : public GxEPD2_4G_EPD
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+    // write two 1bpp planes, native format of 4 grey level write, see GxEPD2_4G_EPD
+    void writeNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                            int16_t x, int16_t y, int16_t w, int16_t h);
     void writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void writeImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
@@ -64,6 +68,12 @@ class GxEPD2_420 : public GxEPD2_4G_EPD
     void refresh(int16_t x, int16_t y, int16_t w, int16_t h); // screen refresh from controller memory, partial screen
     void powerOff(); // turns off generation of panel driving voltages, avoids screen fading over time
     void hibernate(); // turns powerOff() and sets controller to deep sleep for minimum power use, ONLY if wakeable by RST (rst >= 0)
+    // register an alternative LUT set for a refresh mode, 0 restores the built-in tables
+    bool setLutSet(LutMode mode, const LutSet* lut_set);
+    // faster partial update waveform of the Good Display demo, for registerLutSet(lut_partial, &lut_set_partial_fast)
+    static const LutSet lut_set_partial_fast;
+    // built-in short grey waveform for setFastGreyRefresh(), used if no lut_grey_fast set is registered
+    static const LutSet lut_set_grey_fast;
   private:
     void _setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
     void _PowerOn();
@@ -72,10 +82,20 @@ class GxEPD2_420 : public GxEPD2_4G_EPD
     void _Force_Init_Full();
     void _Init_Full();
     void _Init_4G();
+    void _writeLuts_4G();
     void _Init_Part();
     void _Update_Full();
     void _Update_4G();
+    void _Update_4G_Fast();
     void _Update_Part();
+    uint8_t _saveDriverState()
+    {
+      return _refresh_mode;
+    };
+    void _restoreDriverState(uint8_t state)
+    {
+      _refresh_mode = decltype(_refresh_mode)(state);
+    };
   private:
     enum {full_refresh, grey_refresh, fast_refresh, forced_full_refresh} _refresh_mode;
     static const unsigned char lut_20_vcom0_full[];
@@ -93,6 +113,18 @@ class GxEPD2_420 : public GxEPD2_4G_EPD
     static const unsigned char lut_22_bw_partial[];
     static const unsigned char lut_23_wb_partial[];
     static const unsigned char lut_24_bb_partial[];
+    static const unsigned char lut_20_vcom0_partial_fast[];
+    static const unsigned char lut_21_ww_partial_fast[];
+    static const unsigned char lut_22_bw_partial_fast[];
+    static const unsigned char lut_23_wb_partial_fast[];
+    static const unsigned char lut_24_bb_partial_fast[];
+    static const LutTable lut_tables_partial_fast[];
+    static const unsigned char lut_20_vcom0_4G_fast[];
+    static const unsigned char lut_21_ww_4G_fast[];
+    static const unsigned char lut_22_bw_4G_fast[];
+    static const unsigned char lut_23_wb_4G_fast[];
+    static const unsigned char lut_24_bb_4G_fast[];
+    static const LutTable lut_tables_4G_fast[];
 };
 
 #endif
@@ -28,7 +28,8 @@ class GxEPD2_426_GDEQ0426T82 : public GxEPD2_4G_EPD
     static const bool hasPartialUpdate = true; // grey refresh uses full screen
     //static const bool hasFastPartialUpdate = false; // with grey refresh
     static const bool hasFastPartialUpdate = true; // with b/w refresh
-    static const bool useFastFullUpdate = true; // set false for extended (low) temperature range
+    static const bool hasPartialUpdateWindow_4G = false; // grey partial refresh drives full screen (SSD16xx)
+    static const bool useFastFullUpdate = true; // set false for extended (low) temperature range, see also setFastFullUpdateRange()
     static const uint16_t power_on_time = 100; // ms, e.g. 81000us
     static const uint16_t power_off_time = 150; // ms, e.g. 140350us
     static const uint16_t grey_refresh_time = 4000; // ms, e.g. 3943998us
@@ -49,6 +50,11 @@ class GxEPD2_426_GDEQ0426T82 : public GxEPD2_4G_EPD
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+    // write two 1bpp planes, native format of 4 grey level write, see GxEPD2_4G_EPD
+    void writeNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                            int16_t x, int16_t y, int16_t w, int16_t h);
+    // read two 1bpp planes back from controller memory (0x27), needs setReadPins(); x and w must be multiple of 8
+    bool readNativePart_4G(uint8_t* plane1, uint8_t* plane2, int16_t x, int16_t y, int16_t w, int16_t h);
     void writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void writeImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
@@ -75,26 +81,44 @@ class GxEPD2_426_GDEQ0426T82 : public GxEPD2_4G_EPD
     void powerOff(); // turns off generation of panel driving voltages, avoids screen fading over time
     void hibernate(); // turns powerOff() and sets controller to deep sleep for minimum power use, ONLY if wakeable by RST (rst >= 0)
     void drawGreyLevels();
+    // register an alternative LUT set for grey refresh (0x32 and voltages), 0 restores the built-in table
+    // lut_grey_fast : short grey waveform for setFastGreyRefresh(), no built-in one
+    // full and partial refresh use the waveforms from OTP, other modes return false
+    bool setLutSet(LutMode mode, const LutSet* lut_set);
+    // the built-in grey waveform as LUT set, e.g. to register it next to faster ones
+    static const LutSet lut_set_4G;
   private:
     void _writeScreenBuffer(uint8_t command, uint8_t value);
     void _writeScreenBufferArea(uint8_t command, uint8_t value, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
     void _writeImage(uint8_t command, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void _writeImagePart(uint8_t command, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                          int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
-    void _setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void _setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h, bool mirror_y = false);
+    bool _readTemperature(int16_t& celsius);
     void _PowerOn();
     void _PowerOff();
     void _InitDisplay();
     void _Force_Init_Full();
     void _Init_Full();
     void _Init_4G();
+    void _writeLuts_4G();
     void _Init_Part();
     void _Update_Full();
     void _Update_4G();
+    void _Update_4G_Fast();
     void _Update_Part();
+    uint8_t _saveDriverState()
+    {
+      return _refresh_mode;
+    };
+    void _restoreDriverState(uint8_t state)
+    {
+      _refresh_mode = decltype(_refresh_mode)(state);
+    };
   private:
     enum {full_refresh, grey_refresh, fast_refresh, forced_full_refresh} _refresh_mode;
     static const unsigned char lut_4G[];
+    static const LutTable lut_tables_4G[];
 };
 
 #endif
@@ -15,7 +15,7 @@
 #include "GxEPD2_420_GDEY042T81.h"
 
 GxEPD2_420_GDEY042T81::GxEPD2_420_GDEY042T81(int16_t cs, int16_t dc, int16_t rst, int16_t busy) :
-  GxEPD2_4G_EPD(cs, dc, rst, busy, HIGH, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate)
+  GxEPD2_4G_EPD(cs, dc, rst, busy, HIGH, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate, hasPartialUpdateWindow_4G)
 {
   _refresh_mode = full_refresh;
 }
@@ -106,9 +106,10 @@ void GxEPD2_420_GDEY042T81::_writeImage(uint8_t command, const uint8_t bitmap[],
   w1 -= dx;
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
+  int16_t sy = mirror_y ? h - h1 - dy : dy; // first source line, lines are written in reverse order if mirror_y
   if (!_init_display_done) _InitDisplay();
   if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
-  _setPartialRamArea(x1, y1, w1, h1);
+  _setPartialRamArea(x1, y1, w1, h1, mirror_y);
   _writeCommand(command);
   _startTransfer();
   for (int16_t i = 0; i < h1; i++)
@@ -117,7 +118,7 @@ void GxEPD2_420_GDEY042T81::_writeImage(uint8_t command, const uint8_t bitmap[],
     {
       uint8_t data;
       // use wb, h of bitmap for index!
-      int16_t idx = mirror_y ? j + dx / 8 + ((h - 1 - (i + dy))) * wb : j + dx / 8 + (i + dy) * wb;
+      int16_t idx = j + dx / 8 + (i + sy) * wb;
       if (pgm)
       {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -158,8 +159,9 @@ void GxEPD2_420_GDEY042T81::writeImage_4G(const uint8_t bitmap[], uint8_t bpp, i
   w1 -= dx;
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
+  int16_t sy = mirror_y ? h - h1 - dy : dy; // first source line, lines are written in reverse order if mirror_y
   if (!_init_4G_done) _Init_4G();
-  _setPartialRamArea(x1, y1, w1, h1);
+  _setPartialRamArea(x1, y1, w1, h1, mirror_y);
   _writeCommand(0x26);
   _startTransfer();
   for (uint16_t i = 0; i < h1; i++) // lines
@@ -171,7 +173,7 @@ void GxEPD2_420_GDEY042T81::writeImage_4G(const uint8_t bitmap[], uint8_t bpp, i
       {
         uint8_t in_byte;
         // use wb, h of bitmap for index!
-        uint32_t idx = mirror_y ? j + k + dx / ppb + uint32_t((h - 1 - (i + dy))) * wb : j + k + dx / ppb + uint32_t(i + dy) * wb;
+        uint32_t idx = j + k + dx / ppb + uint32_t(i + sy) * wb;
         if (pgm)
         {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -211,7 +213,7 @@ void GxEPD2_420_GDEY042T81::writeImage_4G(const uint8_t bitmap[], uint8_t bpp, i
       {
         uint8_t in_byte;
         // use wb, h of bitmap for index!
-        uint32_t idx = mirror_y ? j + k + dx / ppb + uint32_t((h - 1 - (i + dy))) * wb : j + k + dx / ppb + uint32_t(i + dy) * wb;
+        uint32_t idx = j + k + dx / ppb + uint32_t(i + sy) * wb;
         if (pgm)
         {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -279,10 +281,11 @@ void GxEPD2_420_GDEY042T81::_writeImagePart(uint8_t command, const uint8_t bitma
   w1 -= dx;
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
+  int16_t sy = mirror_y ? h_bitmap - h1 - y_part - dy : y_part + dy; // first source line, lines are written in reverse order if mirror_y
   if (_refresh_mode == grey_refresh) _Force_Init_Full();
   else if (_refresh_mode == full_refresh) _Init_Part();
   if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
-  _setPartialRamArea(x1, y1, w1, h1);
+  _setPartialRamArea(x1, y1, w1, h1, mirror_y);
   _writeCommand(command);
   _startTransfer();
   for (int16_t i = 0; i < h1; i++)
@@ -291,7 +294,7 @@ void GxEPD2_420_GDEY042T81::_writeImagePart(uint8_t command, const uint8_t bitma
     {
       uint8_t data;
       // use wb_bitmap, h_bitmap of bitmap for index!
-      int16_t idx = mirror_y ? x_part / 8 + j + dx / 8 + ((h_bitmap - 1 - (y_part + i + dy))) * wb_bitmap : x_part / 8 + j + dx / 8 + (y_part + i + dy) * wb_bitmap;
+      int16_t idx = x_part / 8 + j + dx / 8 + (i + sy) * wb_bitmap;
       if (pgm)
       {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -338,8 +341,9 @@ void GxEPD2_420_GDEY042T81::writeImagePart_4G(const uint8_t bitmap[], uint8_t bp
   w1 -= dx;
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
+  int16_t sy = mirror_y ? h_bitmap - h1 - y_part - dy : y_part + dy; // first source line, lines are written in reverse order if mirror_y
   if (!_init_4G_done) _Init_4G();
-  _setPartialRamArea(x1, y1, w1, h1);
+  _setPartialRamArea(x1, y1, w1, h1, mirror_y);
   _writeCommand(0x26);
   _startTransfer();
   for (uint16_t i = 0; i < h1; i++) // lines
@@ -351,7 +355,7 @@ void GxEPD2_420_GDEY042T81::writeImagePart_4G(const uint8_t bitmap[], uint8_t bp
       {
         uint8_t in_byte;
         // use wb_bitmap, h_bitmap of bitmap for index!
-        uint32_t idx = mirror_y ? x_part / ppb + j + k + dx / ppb + uint32_t((h_bitmap - 1 - (y_part + i + dy))) * wb_bitmap : x_part / ppb + j + k + dx / ppb + uint32_t(y_part + i + dy) * wb_bitmap;
+        uint32_t idx = x_part / ppb + j + k + dx / ppb + uint32_t(i + sy) * wb_bitmap;
         if (pgm)
         {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -391,7 +395,7 @@ void GxEPD2_420_GDEY042T81::writeImagePart_4G(const uint8_t bitmap[], uint8_t bp
       {
         uint8_t in_byte;
         // use wb_bitmap, h_bitmap of bitmap for index!
-        uint32_t idx = mirror_y ? x_part / ppb + j + k + dx / ppb + uint32_t((h_bitmap - 1 - (y_part + i + dy))) * wb_bitmap : x_part / ppb + j + k + dx / ppb + uint32_t(y_part + i + dy) * wb_bitmap;
+        uint32_t idx = x_part / ppb + j + k + dx / ppb + uint32_t(i + sy) * wb_bitmap;
         if (pgm)
         {
 #if defined(__AVR) || defined(ESP8266) || defined(ESP32)
@@ -423,6 +427,73 @@ void GxEPD2_420_GDEY042T81::writeImagePart_4G(const uint8_t bitmap[], uint8_t bp
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
 
+void GxEPD2_420_GDEY042T81::writeNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                               int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+  if ((w_bitmap < 0) || (h_bitmap < 0) || (w < 0) || (h < 0)) return;
+  if ((x_part < 0) || (x_part >= w_bitmap)) return;
+  if ((y_part < 0) || (y_part >= h_bitmap)) return;
+  int16_t wb_bitmap = (w_bitmap + 7) / 8; // width bytes, bitmaps are padded
+  x_part -= x_part % 8; // byte boundary
+  w = w_bitmap - x_part < w ? w_bitmap - x_part : w; // limit
+  h = h_bitmap - y_part < h ? h_bitmap - y_part : h; // limit
+  x -= x % 8; // byte boundary
+  w = 8 * ((w + 7) / 8); // byte boundary, bitmaps are padded
+  int16_t x1 = x < 0 ? 0 : x; // limit
+  int16_t y1 = y < 0 ? 0 : y; // limit
+  uint16_t w1 = x + w < int16_t(WIDTH) ? w : int16_t(WIDTH) - x; // limit
+  uint16_t h1 = y + h < int16_t(HEIGHT) ? h : int16_t(HEIGHT) - y; // limit
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if ((w1 <= 0) || (h1 <= 0)) return;
+  if (!_init_4G_done) _Init_4G();
+  _setPartialRamArea(x1, y1, w1, h1);
+  _writeCommand(0x26); // controller memory holds the inverted planes, as written by writeImage_4G()
+  _startTransfer();
+  for (uint16_t i = 0; i < h1; i++) // lines
+  {
+    const uint8_t* line = plane1 + x_part / 8 + dx / 8 + uint32_t(y_part + i + dy) * wb_bitmap;
+    for (uint16_t j = 0; j < w1 / 8; j++) _transfer(~line[j]);
+  }
+  _endTransfer();
+  _writeCommand(0x24);
+  _startTransfer();
+  for (uint16_t i = 0; i < h1; i++) // lines
+  {
+    const uint8_t* line = plane2 + x_part / 8 + dx / 8 + uint32_t(y_part + i + dy) * wb_bitmap;
+    for (uint16_t j = 0; j < w1 / 8; j++) _transfer(~line[j]);
+  }
+  _endTransfer();
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+}
+
+bool GxEPD2_420_GDEY042T81::readNativePart_4G(uint8_t* plane1, uint8_t* plane2, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  if (!_canRead()) return false;
+  if ((x % 8) || (w % 8) || (w <= 0) || (h <= 0)) return false;
+  if ((x < 0) || (y < 0) || (x + w > int16_t(WIDTH)) || (y + h > int16_t(HEIGHT))) return false;
+  uint16_t n = (w / 8) * h;
+  _setPartialRamArea(x, y, w, h);
+  _writeCommand(0x41); // read RAM option
+  _writeData(0x01);    // RED RAM (0x26)
+  _writeCommand(0x27); // read RAM, first byte is dummy
+  _readData(plane1, n, 1);
+  _setPartialRamArea(x, y, w, h); // address counter back to start
+  _writeCommand(0x41); // read RAM option
+  _writeData(0x00);    // BW RAM (0x24)
+  _writeCommand(0x27); // read RAM, first byte is dummy
+  _readData(plane2, n, 1);
+  for (uint16_t i = 0; i < n; i++) // back to the plane polarity of writeNativePart_4G()
+  {
+    plane1[i] = ~plane1[i];
+    plane2[i] = ~plane2[i];
+  }
+  return true;
+}
+
 void GxEPD2_420_GDEY042T81::writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   if (black)
@@ -554,23 +625,42 @@ void GxEPD2_420_GDEY042T81::hibernate()
   }
 }
 
-void GxEPD2_420_GDEY042T81::_setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+void GxEPD2_420_GDEY042T81::_setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h, bool mirror_y)
 {
   _writeCommand(0x11); // set ram entry mode
-  _writeData(0x03);    // x increase, y increase : normal mode
+  _writeData(mirror_y ? 0x01 : 0x03); // x increase, y increase : normal mode; y decrease if mirror_y
   _writeCommand(0x44);
   _writeData(x / 8);
   _writeData((x + w - 1) / 8);
+  uint16_t ys = mirror_y ? y + h - 1 : y; // first line written
+  uint16_t ye = mirror_y ? y : y + h - 1;
   _writeCommand(0x45);
-  _writeData(y % 256);
-  _writeData(y / 256);
-  _writeData((y + h - 1) % 256);
-  _writeData((y + h - 1) / 256);
+  _writeData(ys % 256);
+  _writeData(ys / 256);
+  _writeData(ye % 256);
+  _writeData(ye / 256);
   _writeCommand(0x4e);
   _writeData(x / 8);
   _writeCommand(0x4f);
-  _writeData(y % 256);
-  _writeData(y / 256);
+  _writeData(ys % 256);
+  _writeData(ys / 256);
+}
+
+bool GxEPD2_420_GDEY042T81::_readTemperature(int16_t& celsius)
+{
+  if (!_canRead()) return false;
+  uint8_t value[2];
+  _writeCommand(0x18); // use the internal temperature sensor
+  _writeData(0x80);
+  _writeCommand(0x22);
+  _writeData(0xB1); // enable clock, load temperature, load LUT, disable clock
+  _writeCommand(0x20);
+  _waitWhileBusy("_readTemperature", 10);
+  _invalidateLuts(); // LUT register reloaded from OTP
+  _writeCommand(0x1B); // read temperature register
+  _readData(value, 2);
+  celsius = int8_t(value[0]); // A[11:4] integer part, A[3:0] 1/16 degree
+  return true;
 }
 
 void GxEPD2_420_GDEY042T81::_PowerOn()
@@ -603,6 +693,7 @@ void GxEPD2_420_GDEY042T81::_InitDisplay()
   if (_hibernating) _reset();
   delay(10); // 10ms according to specs
   _writeCommand(0x12);  //SWRESET
+  _invalidateLuts(); // SWRESET reloads default LUT
   delay(10); // 10ms according to specs
   _writeCommand(0x01);  // Set MUX as 300
   _writeData(0x2B);
@@ -681,6 +772,7 @@ void GxEPD2_420_GDEY042T81::_Init_4G()
   if (_hibernating) _reset();
   delay(10); // 10ms according to specs
   _writeCommand(0x12);  //SWRESET
+  _invalidateLuts(); // SWRESET reloads default LUT
   delay(10); // 10ms according to specs
   _writeCommand(0x0C); //set soft start
   _writeData(0x8B);
@@ -693,6 +785,18 @@ void GxEPD2_420_GDEY042T81::_Init_4G()
   _writeCommand(0x3C); // Border setting
   _writeData(0x03);
   _setPartialRamArea(0, 0, WIDTH, HEIGHT);
+  _writeLuts_4G();
+  _writeScreenBuffer(0x24, 0x00); // set current
+  _writeScreenBuffer(0x26, 0x00); // set previous
+  _initial_write = false;
+  _init_display_done = false;
+  _init_4G_done = true;
+  _refresh_mode = grey_refresh;
+}
+
+void GxEPD2_420_GDEY042T81::_writeLuts_4G()
+{
+  if (_lutLoaded(0x32, lut_4G)) return; // voltages are loaded together with the LUT
   _writeCommand(0x32);
   _writeDataPGM(lut_4G, 227);
   _writeCommand(0x3F);
@@ -705,12 +809,6 @@ void GxEPD2_420_GDEY042T81::_Init_4G()
   _writeData(lut_4G[231]);//VSL
   _writeCommand(0x2c);
   _writeData(lut_4G[232]);//VCOM
-  _writeScreenBuffer(0x24, 0x00); // set current
-  _writeScreenBuffer(0x26, 0x00); // set previous
-  _initial_write = false;
-  _init_display_done = false;
-  _init_4G_done = true;
-  _refresh_mode = grey_refresh;
 }
 
 void GxEPD2_420_GDEY042T81::_Init_Part()
@@ -722,10 +820,11 @@ void GxEPD2_420_GDEY042T81::_Init_Part()
 
 void GxEPD2_420_GDEY042T81::_Update_Full()
 {
+  bool fast = _useFastFullUpdate(useFastFullUpdate); // may read the temperature sensor
   _writeCommand(0x21); // Display Update Controll
   _writeData(0x40);    // bypass RED as 0
   _writeData(0x00);    // single chip application
-  if (useFastFullUpdate)
+  if (fast)
   {
     _writeCommand(0x1A); // Write to temperature register
     _writeData(0x64);
@@ -744,6 +843,7 @@ void GxEPD2_420_GDEY042T81::_Update_Full()
 
 void GxEPD2_420_GDEY042T81::_Update_4G()
 {
+  _writeLuts_4G(); // skipped if still loaded, reloaded from OTP by _readTemperature()
   _writeCommand(0x21); // Display Update Controll
   _writeData(0x88);    // b/w inverted, RED inverted
   _writeData(0x00);    // single chip application
@@ -14,9 +14,10 @@
 #include "GxEPD2_750_GDEY075T7.h"
 
 GxEPD2_750_GDEY075T7::GxEPD2_750_GDEY075T7(int16_t cs, int16_t dc, int16_t rst, int16_t busy) :
-  GxEPD2_4G_EPD(cs, dc, rst, busy, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate)
+  GxEPD2_4G_EPD(cs, dc, rst, busy, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate, hasPartialUpdateWindow_4G)
 {
   _refresh_mode = full_refresh;
+  _mixed_content = false;
 }
 
 void GxEPD2_750_GDEY075T7::clearScreen(uint8_t value)
@@ -74,8 +75,10 @@ void GxEPD2_750_GDEY075T7::_writeScreenBufferArea(uint8_t command, uint8_t value
 void GxEPD2_750_GDEY075T7::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   //Serial.print("_writeImage("); Serial.print(x); Serial.print(", "); Serial.print(y); Serial.print(", "); Serial.print(w); Serial.print(", "); Serial.print(h); Serial.println(")");
-  if (_refresh_mode == grey_refresh) _writeImage(0x10, bitmap, x, y, w, h, invert, mirror_y, pgm);
+  // from grey with useMixedContent, _Init_Part() keeps grey content and sets _mixed_content, previous is written inverse below
+  if ((_refresh_mode == grey_refresh) && !useMixedContent) _writeImage(0x10, bitmap, x, y, w, h, invert, mirror_y, pgm);
   _writeImage(0x13, bitmap, x, y, w, h, invert, mirror_y, pgm);
+  if (_mixed_content) _writeImage(0x10, bitmap, x, y, w, h, !invert, mirror_y, pgm); // previous inverse : drive all pixels in window
 }
 
 void GxEPD2_750_GDEY075T7::writeImageForFullRefresh(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
@@ -84,11 +87,11 @@ void GxEPD2_750_GDEY075T7::writeImageForFullRefresh(const uint8_t bitmap[], int1
   _writeImage(0x13, bitmap, x, y, w, h, invert, mirror_y, pgm); // set current
 }
 
-//void GxEPD2_750_GDEY075T7::writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
-//{
-//  _writeImage(0x10, bitmap, x, y, w, h, invert, mirror_y, pgm); // set previous
-//  _writeImage(0x13, bitmap, x, y, w, h, invert, mirror_y, pgm); // set current
-//}
+void GxEPD2_750_GDEY075T7::writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  // done by controller (N2OCP), except for mixed content
+  if (_mixed_content) _writeImage(0x10, bitmap, x, y, w, h, invert, mirror_y, pgm); // set previous
+}
 
 void GxEPD2_750_GDEY075T7::_writeImage(uint8_t command, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
@@ -105,7 +108,11 @@ void GxEPD2_750_GDEY075T7::_writeImage(uint8_t command, const uint8_t bitmap[],
   w1 -= dx;
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
-  if (_refresh_mode == grey_refresh) _Force_Init_Full();
+  if (_refresh_mode == grey_refresh)
+  {
+    if (useMixedContent) _Init_Part(); // keeps grey content
+    else _Force_Init_Full();
+  }
   else if (_refresh_mode == full_refresh) _Init_Part();
   if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
   _writeCommand(0x91); // partial in
@@ -252,14 +259,15 @@ void GxEPD2_750_GDEY075T7::writeImagePart(const uint8_t bitmap[], int16_t x_part
     int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   _writeImagePart(0x13, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+  if (_mixed_content) _writeImagePart(0x10, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, !invert, mirror_y, pgm); // previous inverse
 }
 
-//void GxEPD2_750_GDEY075T7::writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
-//    int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
-//{
-//  _writeImagePart(0x13, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
-//  _writeImagePart(0x10, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
-//}
+void GxEPD2_750_GDEY075T7::writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+    int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  // done by controller (N2OCP), except for mixed content
+  if (_mixed_content) _writeImagePart(0x10, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm); // set previous
+}
 
 void GxEPD2_750_GDEY075T7::_writeImagePart(uint8_t command, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
     int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
@@ -283,7 +291,11 @@ void GxEPD2_750_GDEY075T7::_writeImagePart(uint8_t command, const uint8_t bitmap
   w1 -= dx;
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
-  if (_refresh_mode == grey_refresh) _Force_Init_Full();
+  if (_refresh_mode == grey_refresh)
+  {
+    if (useMixedContent) _Init_Part(); // keeps grey content
+    else _Force_Init_Full();
+  }
   else if (_refresh_mode == full_refresh) _Init_Part();
   if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
   _writeCommand(0x91); // partial in
@@ -431,6 +443,51 @@ void GxEPD2_750_GDEY075T7::writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
 
+void GxEPD2_750_GDEY075T7::writeNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                              int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+  if ((w_bitmap < 0) || (h_bitmap < 0) || (w < 0) || (h < 0)) return;
+  if ((x_part < 0) || (x_part >= w_bitmap)) return;
+  if ((y_part < 0) || (y_part >= h_bitmap)) return;
+  int16_t wb_bitmap = (w_bitmap + 7) / 8; // width bytes, bitmaps are padded
+  x_part -= x_part % 8; // byte boundary
+  w = w_bitmap - x_part < w ? w_bitmap - x_part : w; // limit
+  h = h_bitmap - y_part < h ? h_bitmap - y_part : h; // limit
+  x -= x % 8; // byte boundary
+  w = 8 * ((w + 7) / 8); // byte boundary, bitmaps are padded
+  int16_t x1 = x < 0 ? 0 : x; // limit
+  int16_t y1 = y < 0 ? 0 : y; // limit
+  uint16_t w1 = x + w < int16_t(WIDTH) ? w : int16_t(WIDTH) - x; // limit
+  uint16_t h1 = y + h < int16_t(HEIGHT) ? h : int16_t(HEIGHT) - y; // limit
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if ((w1 <= 0) || (h1 <= 0)) return;
+  if (!_init_4G_done) _Init_4G();
+  _writeCommand(0x91); // partial in
+  _setPartialRamArea(x1, y1, w1, h1);
+  _writeCommand(0x10);
+  _startTransfer();
+  for (uint16_t i = 0; i < h1; i++) // lines
+  {
+    const uint8_t* line = plane1 + x_part / 8 + dx / 8 + uint32_t(y_part + i + dy) * wb_bitmap;
+    for (uint16_t j = 0; j < w1 / 8; j++) _transfer(line[j]);
+  }
+  _endTransfer();
+  _writeCommand(0x13);
+  _startTransfer();
+  for (uint16_t i = 0; i < h1; i++) // lines
+  {
+    const uint8_t* line = plane2 + x_part / 8 + dx / 8 + uint32_t(y_part + i + dy) * wb_bitmap;
+    for (uint16_t j = 0; j < w1 / 8; j++) _transfer(line[j]);
+  }
+  _endTransfer();
+  _writeCommand(0x92); // partial out
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+}
+
 void GxEPD2_750_GDEY075T7::writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   if (black)
@@ -539,12 +596,12 @@ void GxEPD2_750_GDEY075T7::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
   if (w1 % 8 > 0) w1 += 8 - w1 % 8;
   x1 -= x1 % 8;
   if (_refresh_mode == full_refresh) _Init_Part();
-  if (usePartialUpdateWindow) _writeCommand(0x91); // partial in
+  if (usePartialUpdateWindow || _mixed_content) _writeCommand(0x91); // partial in
   else if (usePartialUpdateWindow_4G && (_refresh_mode == grey_refresh)) _writeCommand(0x91); // partial in
   _setPartialRamArea(x1, y1, w1, h1);
   if (_refresh_mode == grey_refresh) _Update_4G();
   else _Update_Part();
-  if (usePartialUpdateWindow) _writeCommand(0x92); // partial out
+  if (usePartialUpdateWindow || _mixed_content) _writeCommand(0x92); // partial out
   else if (usePartialUpdateWindow_4G && (_refresh_mode == grey_refresh)) _writeCommand(0x92); // partial out
 }
 
@@ -563,6 +620,7 @@ void GxEPD2_750_GDEY075T7::hibernate()
     _hibernating = true;
     _init_display_done = false;
     _init_4G_done = false;
+    _mixed_content = false;
   }
 }
 
@@ -613,6 +671,7 @@ void GxEPD2_750_GDEY075T7::_InitDisplay()
     // soft reset needed to undo any TSFIX
     _writeCommand(0x00); // PANEL SETTING
     _writeData(0x1e);    // soft reset; KW: 3f, KWR: 2F, BWROTP: 0f, BWOTP: 1f
+    _invalidateLuts(); // soft reset may reset LUT registers
     delay(2);
     _writeCommand(0x00); // PANEL SETTING
     _writeData(0x1f);    // KW: 3f, KWR: 2F, BWROTP: 0f, BWOTP: 1f
@@ -767,6 +826,7 @@ void GxEPD2_750_GDEY075T7::_Init_Full()
   _writeData(0x1f);    // full update LUT from OTP
   _PowerOn();
   _init_4G_done = false;
+  _mixed_content = false;
   if (_refresh_mode == grey_refresh)
   {
     _writeScreenBuffer(0x13, 0xff); // set current
@@ -787,29 +847,29 @@ void GxEPD2_750_GDEY075T7::_Init_4G()
   _writeData(0x07);
   _writeCommand(0x82); // vcom_DC setting
   _writeData (0x30);   // -2.5V same value as in OTP
-  _writeCommand(0x20);
-  _writeDataPGM(lut_20_vcom0_4G, sizeof(lut_20_vcom0_4G));
-  _writeCommand(0x21);
-  _writeDataPGM(lut_21_ww_4G, sizeof(lut_21_ww_4G));
-  _writeCommand(0x22);
-  _writeDataPGM(lut_22_bw_4G, sizeof(lut_22_bw_4G));
-  _writeCommand(0x23);
-  _writeDataPGM(lut_23_wb_4G, sizeof(lut_23_wb_4G));
-  _writeCommand(0x24);
-  _writeDataPGM(lut_24_bb_4G, sizeof(lut_24_bb_4G));
-  _writeCommand(0x25);
-  _writeDataPGM(lut_21_ww_4G, sizeof(lut_21_ww_4G));
-  _writeScreenBuffer(0x13, 0xff); // set current
-  _writeScreenBuffer(0x10, 0xff); // set previous
+  _writeLutPGM(0x20, lut_20_vcom0_4G, sizeof(lut_20_vcom0_4G));
+  _writeLutPGM(0x21, lut_21_ww_4G, sizeof(lut_21_ww_4G));
+  _writeLutPGM(0x22, lut_22_bw_4G, sizeof(lut_22_bw_4G));
+  _writeLutPGM(0x23, lut_23_wb_4G, sizeof(lut_23_wb_4G));
+  _writeLutPGM(0x24, lut_24_bb_4G, sizeof(lut_24_bb_4G));
+  _writeLutPGM(0x25, lut_21_ww_4G, sizeof(lut_21_ww_4G));
+  // b/w content is valid grey content if previous equals current, as after b/w refresh
+  if (!useMixedContent || _initial_write)
+  {
+    _writeScreenBuffer(0x13, 0xff); // set current
+    _writeScreenBuffer(0x10, 0xff); // set previous
+  }
   _initial_write = false;
   _init_display_done = false;
   _init_4G_done = true;
+  _mixed_content = false;
   _refresh_mode = grey_refresh;
 }
 
 void GxEPD2_750_GDEY075T7::_Init_Part()
 {
   //Serial.println("_Init_Part");
+  bool keep_grey = _mixed_content || (useMixedContent && (_refresh_mode == grey_refresh));
   _InitDisplay();
   if (hasFastPartialUpdate)
   {
@@ -835,23 +895,25 @@ void GxEPD2_750_GDEY075T7::_Init_Part()
       _writeCommand(0x50); // VCOM AND DATA INTERVAL SETTING
       _writeData(0x39);    // LUTBD, N2OCP: copy new to old
       _writeData(0x07);
-      _writeCommand(0x20);
-      _writeDataPGM(lut_20_LUTC_partial, sizeof(lut_20_LUTC_partial), 42 - sizeof(lut_20_LUTC_partial));
-      _writeCommand(0x21);
-      _writeDataPGM(lut_21_LUTWW_partial, sizeof(lut_21_LUTWW_partial), 42 - sizeof(lut_21_LUTWW_partial));
-      _writeCommand(0x22);
-      _writeDataPGM(lut_22_LUTKW_partial, sizeof(lut_22_LUTKW_partial), 42 - sizeof(lut_22_LUTKW_partial));
-      _writeCommand(0x23);
-      _writeDataPGM(lut_23_LUTWK_partial, sizeof(lut_23_LUTWK_partial), 42 - sizeof(lut_23_LUTWK_partial));
-      _writeCommand(0x24);
-      _writeDataPGM(lut_24_LUTKK_partial, sizeof(lut_24_LUTKK_partial), 42 - sizeof(lut_24_LUTKK_partial));
-      _writeCommand(0x25);
-      _writeDataPGM(lut_25_LUTBD_partial, sizeof(lut_25_LUTBD_partial), 42 - sizeof(lut_25_LUTBD_partial));
+      _writeLutPGM(0x20, lut_20_LUTC_partial, sizeof(lut_20_LUTC_partial), 42 - sizeof(lut_20_LUTC_partial));
+      _writeLutPGM(0x21, lut_21_LUTWW_partial, sizeof(lut_21_LUTWW_partial), 42 - sizeof(lut_21_LUTWW_partial));
+      _writeLutPGM(0x22, lut_22_LUTKW_partial, sizeof(lut_22_LUTKW_partial), 42 - sizeof(lut_22_LUTKW_partial));
+      _writeLutPGM(0x23, lut_23_LUTWK_partial, sizeof(lut_23_LUTWK_partial), 42 - sizeof(lut_23_LUTWK_partial));
+      _writeLutPGM(0x24, lut_24_LUTKK_partial, sizeof(lut_24_LUTKK_partial), 42 - sizeof(lut_24_LUTKK_partial));
+      _writeLutPGM(0x25, lut_25_LUTBD_partial, sizeof(lut_25_LUTBD_partial), 42 - sizeof(lut_25_LUTBD_partial));
     }
   }
+  if (keep_grey)
+  {
+    _writeCommand(0x50); // VCOM AND DATA INTERVAL SETTING
+    _writeData(hasFastPartialUpdate && !useFastPartialUpdateFromOTP ? 0x31 : 0x21); // no N2OCP, previous keeps grey content
+    _writeData(0x07);
+  }
   _PowerOn();
   _init_4G_done = false;
-  if (_refresh_mode == grey_refresh)
+  _mixed_content = keep_grey;
+  if (keep_grey) _refresh_mode = fast_refresh;
+  else if (_refresh_mode == grey_refresh)
   {
     _writeScreenBuffer(0x13, 0xff); // set current
     _writeScreenBuffer(0x10, 0xff); // set previous
@@ -862,7 +924,8 @@ void GxEPD2_750_GDEY075T7::_Init_Part()
 
 void GxEPD2_750_GDEY075T7::_Update_Full()
 {
-  if (useFastFullUpdate)
+  bool fast = _useFastFullUpdate(useFastFullUpdate); // may read the temperature sensor
+  if (fast)
   {
     _writeCommand(0xE0); // Cascade Setting (CCSET)
     _writeData(0x02);    // TSFIX
@@ -29,8 +29,10 @@ class GxEPD2_750_GDEY075T7 : public GxEPD2_4G_EPD
     static const bool usePartialUpdateWindow = false; // set false for better image
     static const bool usePartialUpdateWindow_4G = false; // set false for acceptable image
     static const bool hasFastPartialUpdate = true; // set this false to force full refresh always
-    static const bool useFastFullUpdate = true; // set false for extended (low) temperature range
+    static const bool hasPartialUpdateWindow_4G = usePartialUpdateWindow_4G; // grey partial refresh limited to window if used
+    static const bool useFastFullUpdate = true; // set false for extended (low) temperature range, see also setFastFullUpdateRange()
     static const bool useFastPartialUpdateFromOTP = true; // set this false for earlier batches, such as the panel I have (1580258us)
+    static const bool useMixedContent = true; // b/w partial window refresh keeps grey content, set false to clear on mode switch
     static const uint16_t power_on_time = 140; // ms, e.g. 128000us
     static const uint16_t power_off_time = 42; // ms, e.g. 40000us
     static const uint16_t grey_refresh_time = 2500; // ms, e.g. 2324000us
@@ -51,14 +53,17 @@ class GxEPD2_750_GDEY075T7 : public GxEPD2_4G_EPD
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void writeImagePart_4G(const uint8_t bitmap[], uint8_t bpp, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+    // write two 1bpp planes, native format of 4 grey level write, see GxEPD2_4G_EPD
+    void writeNativePart_4G(const uint8_t* plane1, const uint8_t* plane2, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                            int16_t x, int16_t y, int16_t w, int16_t h);
     void writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void writeImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     // for differential update: set current and previous buffers equal (for fast partial update to work correctly)
-    // done by controller (N2OCP); override with empty code
-    void writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) {};
+    // done by controller (N2OCP), except for mixed content, where N2OCP is off to keep grey content
+    void writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
-                             int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) {};
+                             int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     // write sprite of native data to controller memory, without screen refresh; x and w should be multiple of 8
     void writeNative(const uint8_t* data1, const uint8_t* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     // write to controller memory, with screen refresh; x and w should be multiple of 8
@@ -94,8 +99,17 @@ class GxEPD2_750_GDEY075T7 : public GxEPD2_4G_EPD
     void _Update_Full();
     void _Update_4G();
     void _Update_Part();
+    uint8_t _saveDriverState()
+    {
+      return _refresh_mode;
+    };
+    void _restoreDriverState(uint8_t state)
+    {
+      _refresh_mode = decltype(_refresh_mode)(state);
+    };
   private:
     enum {full_refresh, grey_refresh, fast_refresh, forced_full_refresh} _refresh_mode;
+    bool _mixed_content; // b/w fast refresh on grey content, RAM planes keep grey encoding
     static const unsigned char lut_20_vcom0_4G[];
     static const unsigned char lut_21_ww_4G[];
     static const unsigned char lut_22_bw_4G[];